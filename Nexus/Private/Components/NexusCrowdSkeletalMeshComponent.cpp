@@ -0,0 +1,61 @@
+// Toyan Green © 2020
+
+
+#include "Components/NexusCrowdSkeletalMeshComponent.h"
+#include "Engine/EngineTypes.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Bone Evaluations Saved"), STAT_CrowdBoneEvaluationsSaved, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Meshes Skipped"), STAT_CrowdMeshesSkipped, STATGROUP_Nexus);
+
+// Sets default values for this component's properties
+UNexusCrowdSkeletalMeshComponent::UNexusCrowdSkeletalMeshComponent()
+{
+	bEnableUpdateRateOptimizations = true;
+
+	VisibleScreenSizeThresholds = { 0.3f, 0.15f, 0.075f };
+}
+
+void UNexusCrowdSkeletalMeshComponent::OnRegister()
+{
+	// Hitboxes are posed by the server, so its meshes must update every frame. Only clients, which just draw the crowd, skip frames.
+	if (IsRunningDedicatedServer() || NM_Client != GetNetMode())
+	{
+		bEnableUpdateRateOptimizations = false;
+	}
+
+	// The update rate parameters are created when the component is registered.
+	OnAnimUpdateRateParamsCreated.BindUObject(this, &UNexusCrowdSkeletalMeshComponent::SetupUpdateRateParameters);
+
+	Super::OnRegister();
+}
+
+// Called every frame
+void UNexusCrowdSkeletalMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Count the bones that were not evaluated this frame, either skipped by the update rate or because the mesh was not rendered.
+	const bool bSkippedEvaluation = AnimUpdateRateParams && AnimUpdateRateParams->ShouldSkipEvaluation();
+	const bool bSkippedRefresh = !bRecentlyRendered && EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones != VisibilityBasedAnimTickOption;
+
+	if (bSkippedEvaluation || bSkippedRefresh)
+	{
+		INC_DWORD_STAT_BY(STAT_CrowdBoneEvaluationsSaved, GetNumComponentSpaceTransforms());
+		INC_DWORD_STAT(STAT_CrowdMeshesSkipped);
+	}
+}
+
+bool UNexusCrowdSkeletalMeshComponent::ShouldUseDetailedAnimation() const
+{
+	return !AnimUpdateRateParams || 1 >= AnimUpdateRateParams->UpdateRate;
+}
+
+void UNexusCrowdSkeletalMeshComponent::SetupUpdateRateParameters(FAnimUpdateRateParameters* UpdateRateParameters) const
+{
+	// Step the rate down by screen size, rather than by mesh LOD, so it is independent of each mesh's LOD setup.
+	UpdateRateParameters->bShouldUseLodMap = false;
+	UpdateRateParameters->BaseVisibleDistanceFactorThesholds = VisibleScreenSizeThresholds;
+	UpdateRateParameters->BaseNonRenderedUpdateRate = NonRenderedUpdateRate;
+	UpdateRateParameters->MaxEvalRateForInterpolation = MaxEvaluationRateForInterpolation;
+}
@@ -54,6 +54,16 @@ void UNexusHealthComponent::RestoreArmour(float ArmourAmount)
 	OnRep_CurrentHealthUpdated();
 }
 
+void UNexusHealthComponent::ResetHealth()
+{
+	CurrentHealth = MaxHealth;
+	CurrentArmour = 0.0f;
+	bDead = false;
+
+	// Broadcast health update locally.
+	OnRep_CurrentHealthUpdated();
+}
+
 bool UNexusHealthComponent::IsFriendly(AActor* Actor1, AActor* Actor2)
 {
 	if (!Actor1 || !Actor2)
@@ -0,0 +1,260 @@
+// Toyan Green © 2020
+
+
+#include "Components/NexusHitboxHistoryComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Subsystems/NexusLagCompensationSubsystem.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox History Record"), STAT_HitboxHistoryRecord, STATGROUP_Nexus);
+
+// Sets default values for this component's properties
+UNexusHitboxHistoryComponent::UNexusHitboxHistoryComponent()
+{
+	// Snapshots are recorded every frame, but only on a server with remote clients. Tick is enabled in BeginPlay.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Record after physics, so the snapshot matches the poses the clients receive for this frame.
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+// Called every frame
+void UNexusHitboxHistoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	RecordSnapshot();
+}
+
+void UNexusHitboxHistoryComponent::SetHitboxComponent(UPrimitiveComponent* NewHitboxComponent)
+{
+	HitboxComponent = NewHitboxComponent;
+
+	ClearHistory();
+}
+
+bool UNexusHitboxHistoryComponent::RewindHitboxes(float RewindTime)
+{
+	if (bHitboxesRewound || 0 == NumHitboxes || 0 == NumRecordedSnapshots || CountHitboxBodies() != NumHitboxes)
+	{
+		return false;
+	}
+
+	// Nothing to do if the requested time is as recent as the newest snapshot.
+	if (RewindTime >= SnapshotTimes[NewestSnapshotIndex])
+	{
+		return false;
+	}
+
+	// Walk back from the newest snapshot to find the pair of snapshots either side of the rewind time.
+	int32 NewerSnapshotIndex = NewestSnapshotIndex;
+	int32 OlderSnapshotIndex = NewestSnapshotIndex;
+
+	for (int32 SnapshotOffset = 1; SnapshotOffset < NumRecordedSnapshots; ++SnapshotOffset)
+	{
+		OlderSnapshotIndex = (NewestSnapshotIndex - SnapshotOffset + MaxSnapshots) % MaxSnapshots;
+
+		if (SnapshotTimes[OlderSnapshotIndex] <= RewindTime)
+		{
+			break;
+		}
+
+		NewerSnapshotIndex = OlderSnapshotIndex;
+	}
+
+	// Interpolate between the two snapshots. If the rewind time is older than the history, the oldest snapshot is used.
+	const float OlderSnapshotTime = SnapshotTimes[OlderSnapshotIndex];
+	const float NewerSnapshotTime = SnapshotTimes[NewerSnapshotIndex];
+	const float SnapshotInterval = NewerSnapshotTime - OlderSnapshotTime;
+	const float Alpha = SnapshotInterval > KINDA_SMALL_NUMBER ? FMath::Clamp((RewindTime - OlderSnapshotTime) / SnapshotInterval, 0.0f, 1.0f) : 1.0f;
+
+	const FHitboxPose* OlderPoses = &SnapshotPoses[OlderSnapshotIndex * NumHitboxes];
+	const FHitboxPose* NewerPoses = &SnapshotPoses[NewerSnapshotIndex * NumHitboxes];
+
+	for (int32 HitboxIndex = 0; HitboxIndex < NumHitboxes; ++HitboxIndex)
+	{
+		FBodyInstance* HitboxBody = GetHitboxBody(HitboxIndex);
+
+		if (!HitboxBody)
+		{
+			continue;
+		}
+
+		// Store the current pose so it can be restored after the trace.
+		const FTransform CurrentTransform = HitboxBody->GetUnrealWorldTransform();
+		RestorePoses[HitboxIndex].Rotation = CurrentTransform.GetRotation();
+		RestorePoses[HitboxIndex].Location = CurrentTransform.GetLocation();
+
+		const FQuat RewoundRotation = FQuat::FastLerp(OlderPoses[HitboxIndex].Rotation, NewerPoses[HitboxIndex].Rotation, Alpha).GetNormalized();
+		const FVector RewoundLocation = FMath::Lerp(OlderPoses[HitboxIndex].Location, NewerPoses[HitboxIndex].Location, Alpha);
+
+		HitboxBody->SetBodyTransform(FTransform(RewoundRotation, RewoundLocation, CurrentTransform.GetScale3D()), ETeleportType::TeleportPhysics, false);
+	}
+
+	bHitboxesRewound = true;
+
+	return true;
+}
+
+void UNexusHitboxHistoryComponent::RestoreHitboxes()
+{
+	if (!bHitboxesRewound)
+	{
+		return;
+	}
+
+	for (int32 HitboxIndex = 0; HitboxIndex < NumHitboxes; ++HitboxIndex)
+	{
+		FBodyInstance* HitboxBody = GetHitboxBody(HitboxIndex);
+
+		if (HitboxBody)
+		{
+			const FTransform CurrentTransform = HitboxBody->GetUnrealWorldTransform();
+
+			HitboxBody->SetBodyTransform(FTransform(RestorePoses[HitboxIndex].Rotation, RestorePoses[HitboxIndex].Location, CurrentTransform.GetScale3D()),
+				ETeleportType::TeleportPhysics, false);
+		}
+	}
+
+	bHitboxesRewound = false;
+}
+
+void UNexusHitboxHistoryComponent::ClearHistory()
+{
+	NewestSnapshotIndex = INDEX_NONE;
+	NumRecordedSnapshots = 0;
+}
+
+void UNexusHitboxHistoryComponent::SetRecordingEnabled(bool bEnabled)
+{
+	if (!bEnabled)
+	{
+		ClearHistory();
+	}
+
+	// The history is only allocated in BeginPlay if it is needed.
+	SetComponentTickEnabled(bEnabled && 0 < SnapshotTimes.Num());
+}
+
+int32 UNexusHitboxHistoryComponent::GetNumHitboxes() const
+{
+	return NumHitboxes;
+}
+
+// Called when the game starts
+void UNexusHitboxHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// History is only needed on the server authority, and only if there are remote clients whose shots need rewinding.
+	if (ROLE_Authority == GetOwnerRole() && NM_Standalone != GetNetMode())
+	{
+		AllocateHistory();
+
+		SetComponentTickEnabled(true);
+
+		UNexusLagCompensationSubsystem* LagCompensationSubsystem = GetWorld()->GetSubsystem<UNexusLagCompensationSubsystem>();
+		if (LagCompensationSubsystem)
+		{
+			LagCompensationSubsystem->RegisterHitboxHistory(this);
+		}
+	}
+}
+
+// Called when the component is removed from play
+void UNexusHitboxHistoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UNexusLagCompensationSubsystem* LagCompensationSubsystem = GetWorld()->GetSubsystem<UNexusLagCompensationSubsystem>();
+	if (LagCompensationSubsystem)
+	{
+		LagCompensationSubsystem->UnregisterHitboxHistory(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FBodyInstance* UNexusHitboxHistoryComponent::GetHitboxBody(int32 HitboxIndex) const
+{
+	if (!HitboxComponent)
+	{
+		return nullptr;
+	}
+
+	// Skeletal meshes have a body per physics asset body. Body pointers are not cached, because they are recreated if the mesh changes.
+	const USkeletalMeshComponent* HitboxSkeletalMesh = Cast<USkeletalMeshComponent>(HitboxComponent);
+	if (HitboxSkeletalMesh)
+	{
+		return HitboxSkeletalMesh->Bodies.IsValidIndex(HitboxIndex) ? HitboxSkeletalMesh->Bodies[HitboxIndex] : nullptr;
+	}
+
+	return 0 == HitboxIndex ? HitboxComponent->GetBodyInstance() : nullptr;
+}
+
+int32 UNexusHitboxHistoryComponent::CountHitboxBodies() const
+{
+	if (!HitboxComponent)
+	{
+		return 0;
+	}
+
+	const USkeletalMeshComponent* HitboxSkeletalMesh = Cast<USkeletalMeshComponent>(HitboxComponent);
+	if (HitboxSkeletalMesh)
+	{
+		return FMath::Min(HitboxSkeletalMesh->Bodies.Num(), MaxHitboxes);
+	}
+
+	return HitboxComponent->GetBodyInstance() ? 1 : 0;
+}
+
+void UNexusHitboxHistoryComponent::AllocateHistory()
+{
+	NumHitboxes = CountHitboxBodies();
+
+	// All snapshot storage is allocated up front. Recording a snapshot only overwrites the oldest slot.
+	SnapshotTimes.SetNumZeroed(MaxSnapshots);
+	SnapshotPoses.SetNumUninitialized(MaxSnapshots * NumHitboxes);
+	RestorePoses.SetNumUninitialized(NumHitboxes);
+
+	ClearHistory();
+}
+
+void UNexusHitboxHistoryComponent::RecordSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitboxHistoryRecord);
+
+	if (bHitboxesRewound)
+	{
+		return;
+	}
+
+	// The number of bodies only changes if the mesh changes, in which case the old history no longer applies.
+	if (CountHitboxBodies() != NumHitboxes)
+	{
+		AllocateHistory();
+	}
+
+	if (0 == NumHitboxes)
+	{
+		return;
+	}
+
+	NewestSnapshotIndex = (NewestSnapshotIndex + 1) % MaxSnapshots;
+	NumRecordedSnapshots = FMath::Min(NumRecordedSnapshots + 1, MaxSnapshots);
+
+	SnapshotTimes[NewestSnapshotIndex] = GetWorld()->GetTimeSeconds();
+
+	FHitboxPose* Poses = &SnapshotPoses[NewestSnapshotIndex * NumHitboxes];
+
+	for (int32 HitboxIndex = 0; HitboxIndex < NumHitboxes; ++HitboxIndex)
+	{
+		const FBodyInstance* HitboxBody = GetHitboxBody(HitboxIndex);
+
+		if (HitboxBody)
+		{
+			const FTransform BodyTransform = HitboxBody->GetUnrealWorldTransform();
+			Poses[HitboxIndex].Rotation = BodyTransform.GetRotation();
+			Poses[HitboxIndex].Location = BodyTransform.GetLocation();
+		}
+	}
+}
@@ -4,7 +4,7 @@
 #include "Components/NexusHealthComponent.h"
 #include "Nexus/Utils/Logging/NexusLogging.h"
 #include "Kismet/GameplayStatics.h"
-#include "PhysicsEngine/RadialForceComponent.h"
+#include "Subsystems/NexusExplosionSubsystem.h"
 #include "Net/UnrealNetwork.h"
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 #include "DrawDebugHelpers.h"
@@ -26,13 +26,6 @@ AExplodingBarrel::AExplodingBarrel()
 	
 	BarrelHealthComponent = CreateDefaultSubobject<UNexusHealthComponent>(TEXT("HealthComponent"));
 
-	RadialForceComponent = CreateDefaultSubobject<URadialForceComponent>(TEXT("RadialForceComponent"));
-	RadialForceComponent->SetupAttachment(RootComponent);
-	RadialForceComponent->bImpulseVelChange = true;
-	// If auto activate is not set to false, the component will run update code that constantly applies forces.
-	RadialForceComponent->bAutoActivate = false;
-	RadialForceComponent->bIgnoreOwningActor = true;
-
 	// Needs to be set to replicate explosion across all clients.
 	SetReplicates(true);
 	SetReplicateMovement(true);
@@ -60,10 +53,6 @@ void AExplodingBarrel::BeginPlay()
 
 	// Wire up health changed event.
 	BarrelHealthComponent->OnHealthChanged.AddDynamic(this, &AExplodingBarrel::HealthChanged);
-
-	// Variables would not set correctly in the constructor, so have to be set here.
-	RadialForceComponent->Radius = ExplosionRadius;
-	RadialForceComponent->ImpulseStrength = RadialImpulseStrength;
 }
 
 void AExplodingBarrel::HealthChanged(UNexusHealthComponent* HealthComponent, float Health, float HealthDelta, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
@@ -98,15 +87,24 @@ void AExplodingBarrel::Explode()
 
 	AController* InstigatorController = ExplosionInstigator ? ExplosionInstigator->GetInstigatorController() : nullptr;
 	
-	// Apply damage to actors around the barrel.
-	UGameplayStatics::ApplyRadialDamage(GetWorld(), ExplosionDamage, GetActorLocation(),
-		ExplosionRadius, BarrelDamageType, {}, this, InstigatorController);
-	
 	// Launch barrel upwards.
 	MeshComponent->AddImpulse(FVector::UpVector * VerticalImpulseStrength, NAME_None, true);
 
-	// Emit radial force.
-	RadialForceComponent->FireImpulse();
+	// Apply damage and radial impulse to actors around the barrel. Barrels set off by this explosion are deferred by the subsystem.
+	UNexusExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UNexusExplosionSubsystem>();
+	if (ExplosionSubsystem)
+	{
+		FNexusExplosion Explosion;
+		Explosion.Origin = GetActorLocation();
+		Explosion.BaseDamage = ExplosionDamage;
+		Explosion.Radius = ExplosionRadius;
+		Explosion.DamageType = BarrelDamageType;
+		Explosion.DamageCauser = this;
+		Explosion.InstigatedBy = InstigatorController;
+		Explosion.ImpulseStrength = RadialImpulseStrength;
+
+		ExplosionSubsystem->QueueExplosion(Explosion);
+	}
 }
 
 void AExplodingBarrel::OnRep_Explode() const
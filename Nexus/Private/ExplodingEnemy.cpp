@@ -6,8 +6,10 @@
 #include "NavigationSystem.h"
 #include "NavigationPath.h"
 #include "Components/NexusHealthComponent.h"
+#include "Components/NexusHitboxHistoryComponent.h"
 #include "Nexus/Utils/Logging/NexusLogging.h"
-#include "PhysicsEngine/RadialForceComponent.h"
+#include "Subsystems/NexusExplosionSubsystem.h"
+#include "Subsystems/NexusSignificanceSubsystem.h"
 #include "Net/UnrealNetwork.h"
 #include "Components/SphereComponent.h"
 #include "NexusCharacter.h"
@@ -35,12 +37,9 @@ AExplodingEnemy::AExplodingEnemy()
 	// Initialise the health component
 	EnemyHealthComponent = CreateDefaultSubobject<UNexusHealthComponent>(TEXT("HealthComponent"));
 
-	RadialForceComponent = CreateDefaultSubobject<URadialForceComponent>(TEXT("RadialForceComponent"));
-	RadialForceComponent->SetupAttachment(RootComponent);
-	RadialForceComponent->bImpulseVelChange = true;
-	// If auto activate is not set to false, the component will run update code that constantly applies forces.
-	RadialForceComponent->bAutoActivate = false;
-	RadialForceComponent->bIgnoreOwningActor = true;
+	// Initialise the hitbox history component.
+	HitboxHistoryComponent = CreateDefaultSubobject<UNexusHitboxHistoryComponent>(TEXT("HitboxHistoryComponent"));
+	HitboxHistoryComponent->SetHitboxComponent(MeshComponent);
 
 	SphereComponent = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComponent"));
 	// Configure collisions to only detect overlaps with pawns and dynamic objects.
@@ -78,7 +77,16 @@ void AExplodingEnemy::Tick(float DeltaTime)
 			FVector MovementForceDirection = NextPathPoint - GetActorLocation();
 			MovementForceDirection.Normalize();
 
-			MeshComponent->AddForce(MovementForceDirection * MovementForce, NAME_None, bVelocityChange);
+			// At a reduced significance the enemy ticks less often than physics steps, so a force would only apply for a single step.
+			// An impulse covering the whole tick keeps the enemy moving at the same speed.
+			if (0.0f < GetActorTickInterval())
+			{
+				MeshComponent->AddImpulse(MovementForceDirection * MovementForce * DeltaTime, NAME_None, bVelocityChange);
+			}
+			else
+			{
+				MeshComponent->AddForce(MovementForceDirection * MovementForce, NAME_None, bVelocityChange);
+			}
 		}
 	}
 
@@ -136,6 +144,13 @@ void AExplodingEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Enemies far from every player tick less often.
+	UNexusSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UNexusSignificanceSubsystem>();
+	if (SignificanceSubsystem)
+	{
+		SignificanceSubsystem->RegisterActor(this);
+	}
+
 	// Enemy movement should only run on the server authority.
 	if (ROLE_Authority == GetLocalRole())
 	{
@@ -150,15 +165,28 @@ void AExplodingEnemy::BeginPlay()
 
 	MaterialInstance = MeshComponent->CreateAndSetMaterialInstanceDynamicFromMaterial(0, MeshComponent->GetMaterial(0));
 
-	// Variables would not set correctly in the constructor, so have to be set here.
-	RadialForceComponent->Radius = ExplosionRadius;
-	RadialForceComponent->ImpulseStrength = RadialImpulseStrength;
-
 	// Set sound effect to be played.
 	MovementAudioComponent->SetSound(MovementSFX);
 	MovementAudioComponent->Play();
 }
 
+void AExplodingEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UNexusSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UNexusSignificanceSubsystem>();
+	if (SignificanceSubsystem)
+	{
+		SignificanceSubsystem->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AExplodingEnemy::OnSignificanceChanged(ENexusSignificanceTier NewTier)
+{
+	// The movement sound cannot be heard from far enough away to be culled.
+	MovementAudioComponent->SetPaused(ENexusSignificanceTier::Culled == NewTier);
+}
+
 void AExplodingEnemy::HealthChanged(UNexusHealthComponent* HealthComponent, float Health, float HealthDelta, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
 {
 	FStringFormatOrderedArguments LogArgs;
@@ -207,18 +235,41 @@ void AExplodingEnemy::Explode()
 	// Damage is scaled with power level.
 	const float DamageToInflict = ExplosionDamage + (ExplosionDamage * CurrentPowerLevel);
 	
-	// Apply damage to actors around the enemy.
-	UGameplayStatics::ApplyRadialDamage(GetWorld(), DamageToInflict, GetActorLocation(), ExplosionRadius, EnemyDamageType, {}, this);
-
-	// Emit radial force.
-	RadialForceComponent->FireImpulse();
+	// Apply damage and radial impulse to actors around the enemy. Enemies and barrels set off by this explosion are deferred by the subsystem.
+	UNexusExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UNexusExplosionSubsystem>();
+	if (ExplosionSubsystem)
+	{
+		FNexusExplosion Explosion;
+		Explosion.Origin = GetActorLocation();
+		Explosion.BaseDamage = DamageToInflict;
+		Explosion.Radius = ExplosionRadius;
+		Explosion.DamageType = EnemyDamageType;
+		Explosion.DamageCauser = this;
+		Explosion.ImpulseStrength = RadialImpulseStrength;
+		// The enemy is the damage causer, so must not be destroyed until the explosion's damage has been applied.
+		Explosion.OnApplied = FSimpleDelegate::CreateUObject(this, &AExplodingEnemy::OnExplosionApplied);
+
+		ExplosionSubsystem->QueueExplosion(Explosion);
+	}
+	else
+	{
+		OnExplosionApplied();
+	}
 
-	// Cannot immediately destroy the enemy because the explosions effects don't have enough time to replicate. Some delay is needed.
-	SetLifeSpan(0.01f);
 	// Ensure the enemy is not visible, and has no collisions during the delay.
 	MeshComponent->SetVisibility(false, true);
 	MeshComponent->SetSimulatePhysics(false); // If simulate physics is true, setting no collisions throws an error.
 	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// The enemy can no longer be shot, so stop recording hitbox history.
+	HitboxHistoryComponent->ClearHistory();
+	HitboxHistoryComponent->SetComponentTickEnabled(false);
+}
+
+void AExplodingEnemy::OnExplosionApplied()
+{
+	// Cannot immediately destroy the enemy because the explosions effects don't have enough time to replicate. Some delay is needed.
+	SetLifeSpan(0.01f);
 }
 
 void AExplodingEnemy::OnRep_Explode() const
@@ -2,14 +2,23 @@
 
 
 #include "GrenadeLauncher.h"
-#include "Kismet/GameplayStatics.h"
+#include "NexusWeaponFirePolicies.h"
+#include "Subsystems/NexusActorPoolSubsystem.h"
 
 void AGrenadeLauncher::StartFiring()
 {
-	// Weapon should fire once, if the time elapsed since the last shot is greater than the fire delay.
-	if (GetWorld()->GetTimeSeconds() >= LastFireTime + WeaponFireDelayTime)
+	StartFiringWithPolicy<FSemiAutomaticTriggerPolicy>();
+}
+
+void AGrenadeLauncher::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Pre-spawn projectiles, so firing does not pay for spawning them. Replicated projectiles are only pooled by the server authority.
+	UNexusActorPoolSubsystem* ActorPoolSubsystem = GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+	if (ActorPoolSubsystem && ROLE_Authority == GetLocalRole())
 	{
-		Fire();
+		ActorPoolSubsystem->WarmPool(ProjectileClass, NumPooledProjectiles);
 	}
 }
 
@@ -19,35 +28,54 @@ void AGrenadeLauncher::Fire()
 
 	if (WeaponOwner && ProjectileClass)
 	{
-		FVector EyeLocation; // Start location for line trace.
-		FRotator EyeRotation;
-		WeaponOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+		FireProjectile(WeaponOwner);
+
+		// Spawn particle effect for muzzle flash.
+		PlayMuzzleEffect();
+
+		PlayCameraShake();
+
+		// This needs to be set to prevent the firing rate getting bypassed with rapid firing input.
+		LastFireTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void AGrenadeLauncher::FireProjectile(AActor* WeaponOwner)
+{
+	FVector EyeLocation; // Start location for line trace.
+	FRotator EyeRotation;
+	WeaponOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
 
-		const FVector MuzzleLocation = MeshComponent->GetSocketLocation(MuzzleSocketName);
+	const FVector MuzzleLocation = MeshComponent->GetSocketLocation(MuzzleSocketName);
 
-		// Set spawn collision handling override.
+	const FTransform SpawnTransform(EyeRotation, MuzzleLocation);
+
+	// Take a projectile from the pool and fire it from the muzzle. Ensure we set the instigator on the projectile.
+	AGrenadeLauncherProjectile* Grenade = nullptr;
+
+	UNexusActorPoolSubsystem* ActorPoolSubsystem = GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+	if (ActorPoolSubsystem)
+	{
+		Grenade = ActorPoolSubsystem->AcquireActor<AGrenadeLauncherProjectile>(ProjectileClass, SpawnTransform, nullptr, Cast<APawn>(WeaponOwner));
+	}
+	else
+	{
 		FActorSpawnParameters ActorSpawnParams;
 		ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ActorSpawnParams.Instigator = Cast<APawn>(WeaponOwner);
 
-		// Ensure we set the instigator on the spawned projectile
-		ActorSpawnParams.Instigator = Cast<APawn>(GetOwner());
-
-		// Spawn the projectile at the muzzle
-		AGrenadeLauncherProjectile* Grenade = GetWorld()->SpawnActor<AGrenadeLauncherProjectile>(
-			ProjectileClass, MuzzleLocation, EyeRotation, ActorSpawnParams);
+		Grenade = GetWorld()->SpawnActor<AGrenadeLauncherProjectile>(ProjectileClass, SpawnTransform, ActorSpawnParams);
 		if (Grenade)
 		{
-			Grenade->SetDamageAmount(WeaponDamage);
-			Grenade->SetDamageType(DamageType);
-			Grenade->SetDamageRadius(DamageRadius);
+			// Activate the projectile, as the pool would have.
+			Grenade->OnAcquiredFromPool();
 		}
+	}
 
-		// Spawn particle effect for muzzle flash.
-		PlayMuzzleEffect();
-
-		PlayCameraShake();
-
-		// This needs to be set to prevent the firing rate getting bypassed with rapid firing input.
-		LastFireTime = GetWorld()->GetTimeSeconds();
+	if (Grenade)
+	{
+		Grenade->SetDamageAmount(WeaponDamage);
+		Grenade->SetDamageType(DamageType);
+		Grenade->SetDamageRadius(DamageRadius);
 	}
 }
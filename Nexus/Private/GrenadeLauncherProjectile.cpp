@@ -5,6 +5,9 @@
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+#include "Subsystems/NexusActorPoolSubsystem.h"
+#include "Subsystems/NexusExplosionSubsystem.h"
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 #include "DrawDebugHelpers.h"
 #include "Nexus/Utils/ConsoleVariables.h"
@@ -38,6 +41,13 @@ AGrenadeLauncherProjectile::AGrenadeLauncherProjectile()
 	InitialLifeSpan = 3.0f;
 }
 
+void AGrenadeLauncherProjectile::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AGrenadeLauncherProjectile, bPoolActive);
+}
+
 void AGrenadeLauncherProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
 	if (nullptr != OtherActor && this != OtherActor)
@@ -77,13 +87,32 @@ void AGrenadeLauncherProjectile::SetDamageType(TSubclassOf<UDamageType> Type)
 
 void AGrenadeLauncherProjectile::Explode()
 {
+	// Only the server authority applies damage and pools the projectile. Clients play the explosion when it is returned to the pool.
+	// Pooled projectiles have already exploded.
+	if (ROLE_Authority != GetLocalRole() || !bPoolActive)
+	{
+		return;
+	}
+
 	AActor* ProjectileOwner = GetInstigator();
 
 	// Spawn particle effect for explosion.
 	PlayExplosionEffect();
 
 	// Apply damage to actors around the projectile.
-	UGameplayStatics::ApplyRadialDamage(GetWorld(), DamageAmount, CollisionComponent->GetComponentLocation(), DamageRadius, DamageType,{}, this, ProjectileOwner->GetInstigatorController());
+	UNexusExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UNexusExplosionSubsystem>();
+	if (ExplosionSubsystem)
+	{
+		FNexusExplosion Explosion;
+		Explosion.Origin = CollisionComponent->GetComponentLocation();
+		Explosion.BaseDamage = DamageAmount;
+		Explosion.Radius = DamageRadius;
+		Explosion.DamageType = DamageType;
+		Explosion.DamageCauser = this;
+		Explosion.InstigatedBy = ProjectileOwner ? ProjectileOwner->GetInstigatorController() : nullptr;
+
+		ExplosionSubsystem->QueueExplosion(Explosion);
+	}
 	
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 	const bool bDrawDebug = CVarDebugWeaponDrawing.GetValueOnGameThread();
@@ -92,8 +121,85 @@ void AGrenadeLauncherProjectile::Explode()
 		DrawDebugSphere(GetWorld(), CollisionComponent->GetComponentLocation(), DamageRadius, 12.0f, FColor::Yellow, false, 1.0f, 0, 1.0f);
 	}
 #endif
-	
-	Destroy();
+
+	// Return the projectile to the pool, so it can be fired again without being respawned.
+	UNexusActorPoolSubsystem* ActorPoolSubsystem = GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+	if (ActorPoolSubsystem)
+	{
+		ActorPoolSubsystem->ReleaseActor(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AGrenadeLauncherProjectile::OnAcquiredFromPool()
+{
+	bPoolActive = true;
+
+	ApplyPoolActiveState();
+
+	// Restart the fuse.
+	SetLifeSpan(InitialLifeSpan);
+
+	if (GetIsReplicated())
+	{
+		// Wake the projectile so clients receive it being fired.
+		SetNetDormancy(DORM_Awake);
+		ForceNetUpdate();
+	}
+}
+
+void AGrenadeLauncherProjectile::OnReleasedToPool()
+{
+	bPoolActive = false;
+
+	ApplyPoolActiveState();
+
+	// Clear the fuse, so the pooled projectile does not explode.
+	SetLifeSpan(0.0f);
+
+	DamageAmount = 0.0f;
+	DamageRadius = 0.0f;
+	DamageType = nullptr;
+
+	if (GetIsReplicated())
+	{
+		// Clients are sent the projectile being pooled, then it stops replicating until it is fired again.
+		ForceNetUpdate();
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void AGrenadeLauncherProjectile::OnRep_PoolActive()
+{
+	// The server plays the explosion effect when the projectile explodes. Clients play it when the projectile is returned to the pool.
+	if (!bPoolActive)
+	{
+		PlayExplosionEffect();
+	}
+
+	ApplyPoolActiveState();
+}
+
+void AGrenadeLauncherProjectile::ApplyPoolActiveState()
+{
+	SetActorHiddenInGame(!bPoolActive);
+	SetActorEnableCollision(bPoolActive);
+
+	if (bPoolActive)
+	{
+		// Relaunch from the spawn transform, as if the projectile was just spawned.
+		ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+		ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+		ProjectileMovement->Activate(true);
+	}
+	else
+	{
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+	}
 }
 
 void AGrenadeLauncherProjectile::PlayExplosionEffect() const
@@ -5,9 +5,18 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "NexusGameState.h"
 #include "Kismet/GameplayStatics.h"
+#include "Components/NexusCrowdSkeletalMeshComponent.h"
+#include "Subsystems/NexusMeshMergeSubsystem.h"
+#include "Engine/SkeletalMesh.h"
+#include "Subsystems/NexusActorPoolSubsystem.h"
+#include "NexusGameModeBase.h"
+#include "Net/UnrealNetwork.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/NexusHitboxHistoryComponent.h"
 
-ANexusAICharacter::ANexusAICharacter()
-	: ANexusCharacter()
+// AI characters use the crowd mesh, so their animation rate drops with screen size.
+ANexusAICharacter::ANexusAICharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UNexusCrowdSkeletalMeshComponent>(ACharacter::MeshComponentName))
 {
 	PerceptionComponent = CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("PerceptionComponent"));
 
@@ -32,10 +41,181 @@ float ANexusAICharacter::GetScoreValue() const
 	return ScoreValue;
 }
 
+bool ANexusAICharacter::IsPooled() const
+{
+	return !bPoolActive;
+}
+
+void ANexusAICharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Clients revive and hide the enemy when it is taken from, or returned to, the pool.
+	DOREPLIFETIME(ANexusAICharacter, bPoolActive);
+}
+
+void ANexusAICharacter::OnAcquiredFromPool()
+{
+	// Newly spawned enemies are already in play.
+	if (bPoolActive)
+	{
+		return;
+	}
+
+	bPoolActive = true;
+
+	ApplyPoolActiveState();
+
+	// Restart the AI with the controller the enemy had before it was pooled.
+	if (PooledController)
+	{
+		PooledController->Possess(this);
+		PooledController = nullptr;
+	}
+	else
+	{
+		SpawnDefaultController();
+	}
+
+	ForceNetUpdate();
+}
+
+void ANexusAICharacter::OnReleasedToPool()
+{
+	bPoolActive = false;
+
+	// Stop the AI, but keep the controller so it can be reused with the enemy.
+	if (Controller)
+	{
+		PooledController = Controller;
+		PooledController->UnPossess();
+	}
+
+	if (CurrentWeapon)
+	{
+		CurrentWeapon->StopFiring();
+	}
+
+	ApplyPoolActiveState();
+
+	ForceNetUpdate();
+}
+
+void ANexusAICharacter::OnSpawnedIntoPool()
+{
+	bPoolActive = false;
+
+	// Hidden without collision until BeginPlay deactivates the rest of the enemy.
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void ANexusAICharacter::SpawnDefaultController()
+{
+	if (bPoolActive)
+	{
+		Super::SpawnDefaultController();
+	}
+}
+
+void ANexusAICharacter::LifeSpanExpired()
+{
+	if (ShouldReturnToPool())
+	{
+		GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>()->ReleaseActor(this);
+	}
+	else
+	{
+		Super::LifeSpanExpired();
+	}
+}
+
+bool ANexusAICharacter::ShouldDestroyWeaponOnDeath() const
+{
+	// Pooled enemies keep their weapons, so they are reused together. Only the server knows if the enemy is pooled, so clients leave the replicated weapon to it.
+	return ROLE_Authority == GetLocalRole() && !ShouldReturnToPool();
+}
+
+bool ANexusAICharacter::ShouldReturnToPool() const
+{
+	// Only the server authority pools replicated actors, and the game mode only takes its pooled enemy class back out of the pool.
+	const ANexusGameModeBase* GameMode = GetWorld()->GetAuthGameMode<ANexusGameModeBase>();
+
+	return ROLE_Authority == GetLocalRole() && GameMode && GameMode->IsPooledEnemyClass(GetClass()) && GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+}
+
+void ANexusAICharacter::OnRep_PoolActive()
+{
+	ApplyPoolActiveState();
+}
+
+void ANexusAICharacter::ApplyPoolActiveState()
+{
+	if (bPoolActive)
+	{
+		Revive();
+
+		RandomizeAppearance();
+
+		RegisterWithSubsystems();
+	}
+	else
+	{
+		// Pooled enemies are not updated by the subsystems. Unregistering restores the full tick rate, so it is done before ticking is disabled.
+		UnregisterFromSubsystems();
+
+		// Hidden enemies cannot be shot, so their hit volumes are not rewound.
+		HitboxHistoryComponent->SetRecordingEnabled(false);
+
+		GetCharacterMovement()->DisableMovement();
+		GetCharacterMovement()->SetComponentTickEnabled(false);
+
+		// Materials are only set for the parts that are randomized, so the previous appearance's materials are cleared.
+		GetMesh()->EmptyOverrideMaterials();
+
+		UStaticMeshComponent* AttachmentComponents[] = { HairMeshComponent, BeardMeshComponent, MaskMeshComponent };
+		for (UStaticMeshComponent* AttachmentComponent : AttachmentComponents)
+		{
+			if (AttachmentComponent)
+			{
+				AttachmentComponent->EmptyOverrideMaterials();
+			}
+		}
+	}
+
+	SetActorHiddenInGame(!bPoolActive);
+	SetActorEnableCollision(bPoolActive);
+	SetActorTickEnabled(bPoolActive);
+	GetMesh()->SetComponentTickEnabled(bPoolActive);
+
+	// The weapons are separate actors, so are hidden with the enemy.
+	ANexusWeapon* Weapons[] = { CurrentWeapon, OffHandWeapon };
+	for (ANexusWeapon* Weapon : Weapons)
+	{
+		if (Weapon)
+		{
+			Weapon->SetActorHiddenInGame(!bPoolActive);
+		}
+	}
+}
+
 void ANexusAICharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (bPoolActive)
+	{
+		RandomizeAppearance();
+	}
+	else
+	{
+		// Spawned into the pool, so the character and weapons are deactivated now they have started up.
+		ApplyPoolActiveState();
+	}
+}
+
+void ANexusAICharacter::RandomizeAppearance()
+{
 	// Randomize character appearance.
 
 	// Character mesh
@@ -55,14 +235,23 @@ void ANexusAICharacter::BeginPlay()
 		}
 	}
 
+	// Skinned parts are merged into the character mesh, rather than attached.
+	TArray<USkeletalMesh*> AppearanceParts;
+	TArray<UMaterialInterface*> AppearancePartMaterials;
+
 	// Hair and Beard
 	if (HairMaterials.Num())
 	{
 		const int RandomHairMaterialIndex = FMath::RandRange(0, HairMaterials.Num() - 1);
 		UMaterialInstance* HairMaterial = HairMaterials[RandomHairMaterialIndex];
 
+		if (SkinnedHairMeshes.Num())
+		{
+			AppearanceParts.Add(SkinnedHairMeshes[FMath::RandRange(0, SkinnedHairMeshes.Num() - 1)]);
+			AppearancePartMaterials.Add(HairMaterial);
+		}
 		// If hair meshes are assigned then hair can be randomized.
-		if (HairMeshes.Num())
+		else if (HairMeshes.Num())
 		{
 			const int RandomCharacterHairMeshIndex = FMath::RandRange(0, HairMeshes.Num() - 1);
 			UStaticMesh* HairMesh = HairMeshes[RandomCharacterHairMeshIndex];
@@ -75,8 +264,13 @@ void ANexusAICharacter::BeginPlay()
 				}
 			}
 		}
+		if (SkinnedBeardMeshes.Num())
+		{
+			AppearanceParts.Add(SkinnedBeardMeshes[FMath::RandRange(0, SkinnedBeardMeshes.Num() - 1)]);
+			AppearancePartMaterials.Add(HairMaterial);
+		}
 		// If beard meshes are assigned then facial hair can be randomized.
-		if (BeardMeshes.Num())
+		else if (BeardMeshes.Num())
 		{
 			const int RandomCharacterBeardMeshIndex = FMath::RandRange(0, BeardMeshes.Num() - 1);
 			UStaticMesh* BeardMesh = BeardMeshes[RandomCharacterBeardMeshIndex];
@@ -92,7 +286,12 @@ void ANexusAICharacter::BeginPlay()
 	}
 
 	// Mask/helmet mesh
-	if (MaskMeshes.Num())
+	if (SkinnedMaskMeshes.Num())
+	{
+		AppearanceParts.Add(SkinnedMaskMeshes[FMath::RandRange(0, SkinnedMaskMeshes.Num() - 1)]);
+		AppearancePartMaterials.Add(MaskMaterials.Num() ? MaskMaterials[FMath::RandRange(0, MaskMaterials.Num() - 1)] : nullptr);
+	}
+	else if (MaskMeshes.Num())
 	{
 		const int RandomMaskMeshIndex = FMath::RandRange(0, MaskMeshes.Num() - 1);
 		UStaticMesh* MaskMesh = MaskMeshes[RandomCharacterMeshIndex];
@@ -111,6 +310,27 @@ void ANexusAICharacter::BeginPlay()
 		}
 	}
 
+	// Attachments replaced by skinned parts are not needed, even if the parts are not merged on this machine.
+	if (SkinnedHairMeshes.Num())
+	{
+		DestroyAttachment(HairMeshComponent);
+	}
+
+	if (SkinnedBeardMeshes.Num())
+	{
+		DestroyAttachment(BeardMeshComponent);
+	}
+
+	if (SkinnedMaskMeshes.Num())
+	{
+		DestroyAttachment(MaskMeshComponent);
+	}
+
+	if (AppearanceParts.Num())
+	{
+		MergeAppearanceParts(AppearanceParts, AppearancePartMaterials);
+	}
+
 	ANexusGameState* GameState = GetWorld()->GetGameState<ANexusGameState>();
 	if (GameState)
 	{
@@ -118,6 +338,58 @@ void ANexusAICharacter::BeginPlay()
 	}
 }
 
+void ANexusAICharacter::MergeAppearanceParts(const TArray<USkeletalMesh*>& Parts, const TArray<UMaterialInterface*>& PartMaterials)
+{
+	// The mesh merge subsystem is not created on a dedicated server, where the parts are not seen.
+	UNexusMeshMergeSubsystem* MeshMergeSubsystem = GetWorld()->GetSubsystem<UNexusMeshMergeSubsystem>();
+	if (!MeshMergeSubsystem || !GetMesh()->SkeletalMesh)
+	{
+		return;
+	}
+
+	TArray<USkeletalMesh*> MergeParts;
+	MergeParts.Reserve(Parts.Num() + 1);
+	MergeParts.Add(GetMesh()->SkeletalMesh);
+	MergeParts.Append(Parts);
+
+	USkeletalMesh* MergedMesh = MeshMergeSubsystem->GetMergedMesh(MergeParts);
+	if (!MergedMesh)
+	{
+		return;
+	}
+
+	// The character mesh's materials come first in the merged mesh, so its material overrides still apply.
+	GetMesh()->SetSkeletalMesh(MergedMesh, false);
+
+	// Slot names can repeat across parts, so each part's material is set on the materials of its own sections in the merged mesh.
+	TArray<int32> PartMaterialIndices;
+	for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+	{
+		UMaterialInterface* PartMaterial = PartMaterials[PartIndex];
+		if (!PartMaterial)
+		{
+			continue;
+		}
+
+		// The character mesh is the first merged part.
+		UNexusMeshMergeSubsystem::GetPartMaterialIndices(MergedMesh, MergeParts, PartIndex + 1, PartMaterialIndices);
+
+		for (const int32 MaterialIndex : PartMaterialIndices)
+		{
+			GetMesh()->SetMaterial(MaterialIndex, PartMaterial);
+		}
+	}
+}
+
+void ANexusAICharacter::DestroyAttachment(UStaticMeshComponent*& MeshComponent)
+{
+	if (MeshComponent)
+	{
+		MeshComponent->DestroyComponent();
+		MeshComponent = nullptr;
+	}
+}
+
 void ANexusAICharacter::PlayHurtSFX() const
 {
 	bool bEasterEggActive = false;
@@ -2,37 +2,80 @@
 
 
 #include "NexusCharacter.h"
-#include "Camera/CameraComponent.h"
-#include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PawnMovementComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Nexus/Utils/NexusTypeDefinitions.h"
 #include "Components/NexusHealthComponent.h"
+#include "Components/NexusHitboxHistoryComponent.h"
 #include "Nexus/Utils/Logging/NexusLogging.h"
 #include "Net/UnrealNetwork.h"
 #include "Kismet/GameplayStatics.h"
 #include "ExplosiveDamageType.h"
 #include "BulletDamageType.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "Components/SceneCaptureComponent2D.h"
-#include "Engine/TextureRenderTarget2D.h"
+#include "Subsystems/NexusSignificanceSubsystem.h"
+#include "Subsystems/NexusCharacterAimSubsystem.h"
+#include "Subsystems/NexusRagdollSubsystem.h"
+#include "Animation/AnimInstance.h"
+#include "EngineUtils.h"
 
-// Sets default values
-ANexusCharacter::ANexusCharacter()
+// Only compile if debugging
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+/**
+ * \brief Log the number of components and bytes used by each character class in the world.
+ * \param World The world to report on.
+ */
+static void ReportCharacterMemory(UWorld* World)
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	struct FCharacterClassMemory
+	{
+		int32 NumInstances = 0;
+		int32 NumComponents = 0;
+		SIZE_T NumBytes = 0;
+	};
+
+	TMap<UClass*, FCharacterClassMemory> ClassMemory;
+
+	for (TActorIterator<ANexusCharacter> CharacterIterator(World); CharacterIterator; ++CharacterIterator)
+	{
+		ANexusCharacter* Character = *CharacterIterator;
+
+		FCharacterClassMemory& Memory = ClassMemory.FindOrAdd(Character->GetClass());
+		++Memory.NumInstances;
+		Memory.NumBytes += Character->GetClass()->GetStructureSize();
 
-	// Initialise the camera components
-	SpringArmComponent = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArmComponent"));
-	SpringArmComponent->bUsePawnControlRotation = true;
-	SpringArmComponent->SetupAttachment(RootComponent);
+		// Each component's object, plus any memory it owns, such as bone transforms.
+		for (const UActorComponent* Component : Character->GetComponents())
+		{
+			++Memory.NumComponents;
+			Memory.NumBytes += Component->GetClass()->GetStructureSize() + Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
 
-	CameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("CameraComponent"));
-	CameraComponent->SetupAttachment(SpringArmComponent);
+	for (const TPair<UClass*, FCharacterClassMemory>& ClassMemoryPair : ClassMemory)
+	{
+		const FCharacterClassMemory& Memory = ClassMemoryPair.Value;
 
-	CharacterCaptureComponent = CreateDefaultSubobject<USceneCaptureComponent2D>(TEXT("CharacterCaptureComponent"));
-	CharacterCaptureComponent->SetupAttachment(GetMesh(), FaceCamSocketName);
+		FNexusLogging::Log(ELogLevel::INFO, FString::Printf(TEXT("%s: %d instances, %d components and %llu bytes per instance."),
+			*ClassMemoryPair.Key->GetName(), Memory.NumInstances, Memory.NumComponents / Memory.NumInstances, static_cast<uint64>(Memory.NumBytes / Memory.NumInstances)), ELogOutput::OUTPUT_LOG);
+	}
+}
+
+static FAutoConsoleCommandWithWorld CharacterMemoryReportCommand(
+	TEXT("Nexus.CharacterMemoryReport"),
+	TEXT("Log the components and bytes used per instance of each character class."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&ReportCharacterMemory),
+	ECVF_Cheat);
+
+#endif
+
+// Sets default values
+ANexusCharacter::ANexusCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+ 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
 
 	ArmourMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ArmourMeshComponent"));
 	ArmourMeshComponent->SetupAttachment(GetMesh(), ArmourSocketName);
@@ -56,6 +99,10 @@ ANexusCharacter::ANexusCharacter()
 	
 	// Initialise the health component
 	CharacterHealthComponent = CreateDefaultSubobject<UNexusHealthComponent>(TEXT("HealthComponent"));
+
+	// Initialise the hitbox history component. Weapon traces hit the mesh physics bodies, so those are what get rewound.
+	HitboxHistoryComponent = CreateDefaultSubobject<UNexusHitboxHistoryComponent>(TEXT("HitboxHistoryComponent"));
+	HitboxHistoryComponent->SetHitboxComponent(GetMesh());
 	
 	// Disable weapon collisions on the capsule component so that the mesh collisions work as expected.
 	GetCapsuleComponent()->SetCollisionResponseToChannel(COLLISION_OBJECT_PROJECTILE, ECR_Ignore);
@@ -73,46 +120,13 @@ void ANexusCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	SetAimDownSight(DeltaTime);
-
-	SetAimAngles(DeltaTime);
-}
-
-// Called to bind functionality to input
-void ANexusCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
-{
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
-
-	PlayerInputComponent->BindAxis(MoveForwardBindingName, this, &ANexusCharacter::MoveForward);
-	PlayerInputComponent->BindAxis(MoveRightBindingName, this, &ANexusCharacter::MoveRight);
-
-	PlayerInputComponent->BindAxis(LookUpBindingName, this, &ANexusCharacter::AddControllerPitchInput);
-	PlayerInputComponent->BindAxis(TurnBindingName, this, &ANexusCharacter::AddControllerYawInput);
-
-	PlayerInputComponent->BindAction(CrouchBindingName, IE_Pressed, this, &ANexusCharacter::ToggleCrouch);
-
-	PlayerInputComponent->BindAction(JumpBindingName, IE_Pressed, this, &ANexusCharacter::Jump);
-
-	PlayerInputComponent->BindAction(AimingBindingName, IE_Pressed, this, &ANexusCharacter::StartADS);
-	PlayerInputComponent->BindAction(AimingBindingName, IE_Released, this, &ANexusCharacter::EndADS);
-
-	PlayerInputComponent->BindAction(ShootBindingName, IE_Pressed, this, &ANexusCharacter::StartShooting);
-	PlayerInputComponent->BindAction(ShootBindingName, IE_Released, this, &ANexusCharacter::StopShooting);
-
-	PlayerInputComponent->BindAction(ReloadBindingName, IE_Released, this, &ANexusCharacter::StartReloading);
-	
-	PlayerInputComponent->BindAction(SwapWeaponBindingName, IE_Released, this, &ANexusCharacter::InitiateWeaponSwap);
-}
-
-FVector ANexusCharacter::GetPawnViewLocation() const
-{
-	if (CameraComponent)
+	// The server sets the replicated aim angles. Clients smooth them in the character aim subsystem.
+	if (ROLE_Authority == GetLocalRole())
 	{
-		// View for character should be that of the 3rd person camera.
-		return CameraComponent->GetComponentLocation();
-	}
+		GetTargetAimAngles(AimPitchAngle, AimYawAngle);
 
-	return Super::GetPawnViewLocation();
+		UpdateReplicatedAimAngles();
+	}
 }
 
 void ANexusCharacter::Jump()
@@ -141,12 +155,51 @@ bool ANexusCharacter::IsAimingDownSights() const
 
 float ANexusCharacter::GetAimPitch() const
 {
-	return AimPitchAngle;
+	// The dedicated server does not smooth the aim, as the angles are only used to pose the hitboxes.
+	return IsNetMode(NM_DedicatedServer) ? AimPitchAngle : SmoothedAimPitchAngle;
 }
 
 float ANexusCharacter::GetAimYaw() const
 {
-	return AimYawAngle;
+	return IsNetMode(NM_DedicatedServer) ? AimYawAngle : SmoothedAimYawAngle;
+}
+
+void ANexusCharacter::GetTargetAimAngles(float& PitchOut, float& YawOut) const
+{
+	// Simulated proxies have no controller, so aim towards the angles replicated by the server.
+	if (!Controller)
+	{
+		PitchOut = FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(ReplicatedAimPitch));
+		YawOut = FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(ReplicatedAimYaw));
+		return;
+	}
+
+	// Calculate aim angles to drive aim animation offsets.
+	const FRotator DeltaRotation = (GetControlRotation() - GetActorRotation()).GetNormalized();
+
+	PitchOut = FMath::ClampAngle(DeltaRotation.Pitch, -90, 90);
+	YawOut = FMath::ClampAngle(DeltaRotation.Yaw, -90, 90);
+}
+
+void ANexusCharacter::UpdateReplicatedAimAngles()
+{
+	const float ReplicatedPitch = FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(ReplicatedAimPitch));
+	const float ReplicatedYaw = FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(ReplicatedAimYaw));
+
+	// Small changes are not replicated, so characters holding their aim steady send nothing.
+	if (AimReplicationThreshold >= FMath::Abs(AimPitchAngle - ReplicatedPitch) && AimReplicationThreshold >= FMath::Abs(AimYawAngle - ReplicatedYaw))
+	{
+		return;
+	}
+
+	ReplicatedAimPitch = FRotator::CompressAxisToShort(AimPitchAngle);
+	ReplicatedAimYaw = FRotator::CompressAxisToShort(AimYawAngle);
+}
+
+void ANexusCharacter::SetSmoothedAimAngles(float Pitch, float Yaw)
+{
+	SmoothedAimPitchAngle = Pitch;
+	SmoothedAimYawAngle = Yaw;
 }
 
 bool ANexusCharacter::IsLeftHandHoldingWeapon() const
@@ -224,6 +277,13 @@ void ANexusCharacter::DeathRagdollCharacter() const
 
 	GetMesh()->bBlendPhysics = true;
 
+	// The ragdoll budget freezes ragdolls once they settle, or when too many are simulating.
+	UNexusRagdollSubsystem* RagdollSubsystem = GetWorld()->GetSubsystem<UNexusRagdollSubsystem>();
+	if (RagdollSubsystem)
+	{
+		RagdollSubsystem->RegisterRagdoll(GetMesh());
+	}
+
 	// Weapon ragdoll.
 	if (CurrentWeapon)
 	{
@@ -234,6 +294,11 @@ void ANexusCharacter::DeathRagdollCharacter() const
 			WeaponMeshComponent->SetSimulatePhysics(true);
 			WeaponMeshComponent->bBlendPhysics = true;
 			WeaponMeshComponent->DetachFromComponent(FDetachmentTransformRules(EDetachmentRule::KeepWorld, true));
+
+			if (RagdollSubsystem)
+			{
+				RagdollSubsystem->RegisterRagdoll(WeaponMeshComponent);
+			}
 		}		
 	}
 }
@@ -320,6 +385,10 @@ void ANexusCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& Ou
 
 	// Replicate the dead flag so that we can replicate the death animation.
 	DOREPLIFETIME(ANexusCharacter, bDead);
+
+	// The owning client calculates its aim from its own control rotation.
+	DOREPLIFETIME_CONDITION(ANexusCharacter, ReplicatedAimPitch, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ANexusCharacter, ReplicatedAimYaw, COND_SkipOwner);
 }
 
 // Called when the game starts or when spawned
@@ -327,9 +396,6 @@ void ANexusCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Cache FOV so that we can reset when we stop ADS.
-	DefaultFOV = CameraComponent->FieldOfView;
-
 	// Cache max walk speed so we can reset when we stop ADS or speed boost.
 	DefaultMaxWalkSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	// Cache max crouch speed so we can reset when we stop  speed boost.
@@ -342,6 +408,73 @@ void ANexusCharacter::BeginPlay()
 
 	// Initialise the armour visibility.
 	SetArmourVisibility();
+
+	// Cache the animation tick option so that it can be restored when the character becomes significant.
+	DefaultVisibilityBasedAnimTickOption = GetMesh()->VisibilityBasedAnimTickOption;
+
+	RegisterWithSubsystems();
+}
+
+// Called when the character is removed from the level
+void ANexusCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANexusCharacter::RegisterWithSubsystems()
+{
+	UNexusSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UNexusSignificanceSubsystem>();
+	if (SignificanceSubsystem)
+	{
+		SignificanceSubsystem->RegisterActor(this);
+	}
+
+	// The aim subsystem is not created on a dedicated server.
+	UNexusCharacterAimSubsystem* AimSubsystem = GetWorld()->GetSubsystem<UNexusCharacterAimSubsystem>();
+	if (AimSubsystem)
+	{
+		AimSubsystem->RegisterCharacter(this);
+	}
+}
+
+void ANexusCharacter::UnregisterFromSubsystems()
+{
+	UNexusSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UNexusSignificanceSubsystem>();
+	if (SignificanceSubsystem)
+	{
+		SignificanceSubsystem->UnregisterActor(this);
+	}
+
+	UNexusCharacterAimSubsystem* AimSubsystem = GetWorld()->GetSubsystem<UNexusCharacterAimSubsystem>();
+	if (AimSubsystem)
+	{
+		AimSubsystem->UnregisterCharacter(this);
+	}
+}
+
+void ANexusCharacter::OnSignificanceChanged(ENexusSignificanceTier NewTier)
+{
+	// The server keeps full animation, as the hitbox history is recorded from the mesh's bones.
+	if (NM_Client == GetNetMode())
+	{
+		switch (NewTier)
+		{
+		case ENexusSignificanceTier::Low:
+			GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+			break;
+		case ENexusSignificanceTier::Culled:
+			GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+			break;
+		default:
+			GetMesh()->VisibilityBasedAnimTickOption = DefaultVisibilityBasedAnimTickOption;
+			break;
+		}
+	}
+
+	// Shadows from small attachments are not noticeable at a distance.
+	SetCosmeticShadowsEnabled(ENexusSignificanceTier::Low > NewTier);
 }
 
 /**
@@ -429,6 +562,9 @@ void ANexusCharacter::HealthChanged(UNexusHealthComponent* HealthComponent, floa
 		
 		bDead = true;
 
+		// Dead characters cannot be shot, so stop recording hitbox history.
+		HitboxHistoryComponent->SetRecordingEnabled(false);
+
 		// Disable all collisions on capsule component.
 		UCapsuleComponent* cCapsuleCollider = GetCapsuleComponent();
 		cCapsuleCollider->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -456,7 +592,7 @@ void ANexusCharacter::HealthChanged(UNexusHealthComponent* HealthComponent, floa
 		// Setting the lifespan will cause the character/weapons to be destroyed after the time value passed.
 		SetLifeSpan(DeathLifeSpan);
 
-		if (CurrentWeapon)
+		if (CurrentWeapon && ShouldDestroyWeaponOnDeath())
 		{
 			CurrentWeapon->SetLifeSpan(DeathLifeSpan);
 		}		
@@ -471,6 +607,69 @@ void ANexusCharacter::HealthChanged(UNexusHealthComponent* HealthComponent, floa
 	}
 }
 
+bool ANexusCharacter::ShouldDestroyWeaponOnDeath() const
+{
+	return true;
+}
+
+void ANexusCharacter::Revive()
+{
+	bDead = false;
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance)
+	{
+		// Stop the death animation.
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	ResetRagdollMesh(GetMesh());
+
+	// Simulating physics detached the mesh from the capsule.
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+
+	if (CurrentWeapon)
+	{
+		ResetRagdollMesh(Cast<USkeletalMeshComponent>(CurrentWeapon->GetRootComponent()));
+		AttachWeaponToSocket(CurrentWeapon, EquippedWeaponSocketName);
+	}
+
+	// Restore the capsule collision disabled on death.
+	UCapsuleComponent* cCapsuleCollider = GetCapsuleComponent();
+	const UCapsuleComponent* DefaultCapsuleCollider = Cast<UCapsuleComponent>(cCapsuleCollider->GetArchetype());
+	if (DefaultCapsuleCollider)
+	{
+		cCapsuleCollider->SetCollisionResponseToChannels(DefaultCapsuleCollider->GetCollisionResponseToChannels());
+		cCapsuleCollider->SetCollisionEnabled(DefaultCapsuleCollider->GetCollisionEnabled());
+	}
+
+	GetMovementComponent()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	HitboxHistoryComponent->SetRecordingEnabled(true);
+
+	if (ROLE_Authority == GetLocalRole())
+	{
+		CharacterHealthComponent->ResetHealth();
+
+		if (bAimDownSight)
+		{
+			EndADS();
+		}
+
+		FillAmmo();
+
+		if (CurrentWeapon)
+		{
+			CurrentWeapon->StopReloading();
+			CurrentWeapon->SetWeaponState(EWeaponState::Idle);
+		}
+	}
+
+	SetArmourVisibility();
+}
+
 void ANexusCharacter::ServerPlayAnimationMontage_Implementation(UAnimMontage* AnimMontage, float PlaybackRate)
 {
 	// To get something to execute on all clients (and the server), you need to use a NetMulticast function, that is called from the server.
@@ -502,34 +701,6 @@ void ANexusCharacter::PlayDeathSFX() const
 	}
 }
 
-void ANexusCharacter::SetAimDownSight(float DeltaTime)
-{
-	// Interpolate the aim down sight for a smooth aim in/out.
-	
-	const float TargetFOV = bAimDownSight ? AimingFOV : DefaultFOV;
-
-	const float InterpolationFOV = FMath::FInterpTo(CameraComponent->FieldOfView, TargetFOV, DeltaTime, ADSInterpolationSpeed);
-
-	CameraComponent->SetFieldOfView(InterpolationFOV);
-}
-
-void ANexusCharacter::SetAimAngles(float DeltaTime)
-{
-	// Calculate aim angles to drive aim animation offsets.
-	
-	const FRotator ControlRotation = GetControlRotation();
-	const FRotator ActorRotation = GetActorRotation();
-
-	const FRotator DeltaRotation = ControlRotation - ActorRotation;
-
-	const FRotator CurrentAimRotation(AimPitchAngle, AimYawAngle, 0);
-
-	const FRotator NewAimRotation = FMath::RInterpTo(CurrentAimRotation, DeltaRotation, DeltaTime, 15);
-
-	AimPitchAngle = FMath::ClampAngle(NewAimRotation.Pitch, -90, 90);
-	AimYawAngle = FMath::ClampAngle(NewAimRotation.Yaw, -90, 90);
-}
-
 void ANexusCharacter::PlayCrouchSFX() const
 {
 	if (CrouchSFX)
@@ -624,6 +795,52 @@ void ANexusCharacter::AttachWeaponToSocket(ANexusWeapon*& Weapon, const FName& S
 	Weapon->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, SocketName);
 }
 
+void ANexusCharacter::ResetRagdollMesh(USkeletalMeshComponent* RagdollMesh) const
+{
+	if (!RagdollMesh)
+	{
+		return;
+	}
+
+	// The ragdoll may still be simulating, or may have been frozen by the ragdoll budget.
+	UNexusRagdollSubsystem* RagdollSubsystem = GetWorld()->GetSubsystem<UNexusRagdollSubsystem>();
+	if (RagdollSubsystem)
+	{
+		RagdollSubsystem->UnregisterRagdoll(RagdollMesh);
+	}
+
+	RagdollMesh->SetAllBodiesSimulatePhysics(false);
+	RagdollMesh->SetSimulatePhysics(false);
+	RagdollMesh->SetAllBodiesPhysicsBlendWeight(0.0f);
+	RagdollMesh->SetComponentTickEnabled(true);
+
+	const USkeletalMeshComponent* DefaultRagdollMesh = Cast<USkeletalMeshComponent>(RagdollMesh->GetArchetype());
+	if (DefaultRagdollMesh)
+	{
+		RagdollMesh->SetCollisionProfileName(DefaultRagdollMesh->GetCollisionProfileName());
+		RagdollMesh->bUpdateJointsFromAnimation = DefaultRagdollMesh->bUpdateJointsFromAnimation;
+		RagdollMesh->bBlendPhysics = DefaultRagdollMesh->bBlendPhysics;
+	}
+}
+
+void ANexusCharacter::SetCosmeticShadowsEnabled(bool bCastShadows)
+{
+	UPrimitiveComponent* CosmeticComponents[] = { ArmourMeshComponent, BagMeshComponent, HairMeshComponent, BeardMeshComponent, MaskMeshComponent };
+
+	for (UPrimitiveComponent* CosmeticComponent : CosmeticComponents)
+	{
+		// Attachments merged into the character mesh are destroyed.
+		if (!CosmeticComponent)
+		{
+			continue;
+		}
+
+		// Shadows are only restored on meshes that cast them by default.
+		const UPrimitiveComponent* DefaultComponent = Cast<UPrimitiveComponent>(CosmeticComponent->GetArchetype());
+		CosmeticComponent->SetCastShadow(bCastShadows && (!DefaultComponent || DefaultComponent->CastShadow));
+	}
+}
+
 void ANexusCharacter::SetArmourVisibility()
 {
 	ArmourMeshComponent->SetVisibility(0 < CharacterHealthComponent->GetCurrentArmour());
@@ -3,6 +3,7 @@
 
 #include "NexusCharacterAnimInstance.h"
 #include "NexusCharacter.h"
+#include "Components/NexusCrowdSkeletalMeshComponent.h"
 #include "GameFramework/PawnMovementComponent.h"
 
 UNexusCharacterAnimInstance::UNexusCharacterAnimInstance()
@@ -11,40 +12,107 @@ UNexusCharacterAnimInstance::UNexusCharacterAnimInstance()
 	, bCrouching(false)
 	, Speed(0.0f)
 	, Direction(0.0f)
+	, bAimOffsetEnabled(true)
 	, bLeftHandHoldingWeapon(false)
 {
 }
 
-void UNexusCharacterAnimInstance::NativeInitializeAnimation()
+FAnimInstanceProxy* UNexusCharacterAnimInstance::CreateAnimInstanceProxy()
 {
-	Super::NativeInitializeAnimation();
+	return &Proxy;
+}
 
-	// Cache owner for later use
-	Owner = TryGetPawnOwner();
+void UNexusCharacterAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	// The proxy is a member, so is not deleted.
 }
 
-void UNexusCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+void FNexusCharacterAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
 {
-	Super::NativeUpdateAnimation(DeltaSeconds);
+	Super::Initialize(InAnimInstance);
+
+	NexusAnimInstance = CastChecked<UNexusCharacterAnimInstance>(InAnimInstance);
 
-	if (Owner && Owner->IsA(ANexusCharacter::StaticClass()))
+	// Cache the character, so the cast is not repeated every frame.
+	Character = Cast<ANexusCharacter>(InAnimInstance->TryGetPawnOwner());
+
+	CrowdMesh = Cast<UNexusCrowdSkeletalMeshComponent>(InAnimInstance->GetSkelMeshComponent());
+}
+
+void FNexusCharacterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	if (!Character)
 	{
-		const auto cPlayerCharacter = Cast<ANexusCharacter>(Owner);
-
-		if (cPlayerCharacter)
-		{
-			// Set animation variables
-			bJumpEnabled = cPlayerCharacter->bWasJumping;
-			bInAir = cPlayerCharacter->GetMovementComponent()->IsFalling();
-			bCrouching = cPlayerCharacter->bIsCrouched;
-			Speed = cPlayerCharacter->GetVelocity().Size();
-			Direction = CalculateDirection(cPlayerCharacter->GetVelocity(), cPlayerCharacter->GetActorRotation());
-			bDead = cPlayerCharacter->IsDead();
-			bAimingDownSights = cPlayerCharacter->IsAimingDownSights();
-			AimPitch = cPlayerCharacter->GetAimPitch();
-			AimYaw = cPlayerCharacter->GetAimYaw();
-			bLeftHandHoldingWeapon = cPlayerCharacter->IsLeftHandHoldingWeapon();
-			LeftHandWeaponIKSocketTransform = cPlayerCharacter->GetLeftHandWeaponIKSocketTransform();
-		}
+		return;
 	}
-}
\ No newline at end of file
+
+	// Gather the character state on the game thread.
+	AnimData.bJumpEnabled = Character->bWasJumping;
+	AnimData.bInAir = Character->GetMovementComponent()->IsFalling();
+	AnimData.bCrouching = Character->bIsCrouched;
+	AnimData.Velocity = Character->GetVelocity();
+	AnimData.ActorRotation = Character->GetActorRotation();
+	AnimData.bDead = Character->IsDead();
+	AnimData.bAimingDownSights = Character->IsAimingDownSights();
+	// Crowd characters that are animating at a reduced rate are too small on screen for IK and aim offsets to be noticed.
+	AnimData.bDetailedAnimation = !CrowdMesh || CrowdMesh->ShouldUseDetailedAnimation();
+
+	if (AnimData.bDetailedAnimation)
+	{
+		AnimData.AimPitch = Character->GetAimPitch();
+		AnimData.AimYaw = Character->GetAimYaw();
+	}
+
+	AnimData.bLeftHandHoldingWeapon = AnimData.bDetailedAnimation && Character->IsLeftHandHoldingWeapon();
+
+	// The socket lookup is only needed while the left hand IK is used.
+	if (AnimData.bLeftHandHoldingWeapon)
+	{
+		AnimData.LeftHandWeaponIKSocketTransform = Character->GetLeftHandWeaponIKSocketTransform();
+	}
+}
+
+void FNexusCharacterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	if (!Character)
+	{
+		return;
+	}
+
+	// Set animation variables. This runs on the animation worker thread, before the anim graph reads the variables.
+	NexusAnimInstance->bJumpEnabled = AnimData.bJumpEnabled;
+	NexusAnimInstance->bInAir = AnimData.bInAir;
+	NexusAnimInstance->bCrouching = AnimData.bCrouching;
+	NexusAnimInstance->Speed = AnimData.Velocity.Size();
+	NexusAnimInstance->Direction = CalculateDirection(AnimData.Velocity, AnimData.ActorRotation);
+	NexusAnimInstance->bDead = AnimData.bDead;
+	NexusAnimInstance->bAimingDownSights = AnimData.bAimingDownSights;
+	NexusAnimInstance->AimPitch = AnimData.AimPitch;
+	NexusAnimInstance->AimYaw = AnimData.AimYaw;
+	NexusAnimInstance->bAimOffsetEnabled = AnimData.bDetailedAnimation;
+	NexusAnimInstance->bLeftHandHoldingWeapon = AnimData.bLeftHandHoldingWeapon;
+	NexusAnimInstance->LeftHandWeaponIKSocketTransform = AnimData.LeftHandWeaponIKSocketTransform;
+}
+
+float FNexusCharacterAnimInstanceProxy::CalculateDirection(const FVector& Velocity, const FRotator& BaseRotation)
+{
+	if (Velocity.IsNearlyZero())
+	{
+		return 0.0f;
+	}
+
+	const FRotationMatrix RotationMatrix(BaseRotation);
+	const FVector NormalizedVelocity = Velocity.GetSafeNormal2D();
+
+	const float ForwardCosAngle = FVector::DotProduct(RotationMatrix.GetScaledAxis(EAxis::X), NormalizedVelocity);
+	const float ForwardDeltaDegrees = FMath::RadiansToDegrees(FMath::Acos(ForwardCosAngle));
+
+	// Velocity to the left of the character is a negative direction.
+	const float RightCosAngle = FVector::DotProduct(RotationMatrix.GetScaledAxis(EAxis::Y), NormalizedVelocity);
+
+	return 0.0f > RightCosAngle ? -ForwardDeltaDegrees : ForwardDeltaDegrees;
+}
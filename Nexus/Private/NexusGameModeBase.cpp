@@ -8,6 +8,9 @@
 #include "NexusPlayerState.h"
 #include "Kismet/GameplayStatics.h"
 #include "NexusAICharacter.h"
+#include "Subsystems/NexusActorPoolSubsystem.h"
+#include "NavigationSystem.h"
+#include "Components/CapsuleComponent.h"
 
 ANexusGameModeBase::ANexusGameModeBase()
 {
@@ -26,6 +29,13 @@ void ANexusGameModeBase::StartPlay()
 {
 	Super::StartPlay();
 
+	// Enough enemies for a full map are spawned up front. Dead enemies are returned to the pool and reused by later waves.
+	UNexusActorPoolSubsystem* ActorPoolSubsystem = GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+	if (ActorPoolSubsystem && PooledEnemyClass)
+	{
+		ActorPoolSubsystem->WarmPool(PooledEnemyClass, MaxEnemiesOnMap + 1);
+	}
+
 	PrepareForNextWave();
 }
 
@@ -70,6 +80,61 @@ void ANexusGameModeBase::PrepareForNextWave()
 	SetWaveState(EWaveState::PreparingNextWave);
 }
 
+ANexusAICharacter* ANexusGameModeBase::AcquireEnemy(TSubclassOf<ANexusAICharacter> EnemyClass, const FTransform& SpawnTransform)
+{
+	UNexusActorPoolSubsystem* ActorPoolSubsystem = GetWorld()->GetSubsystem<UNexusActorPoolSubsystem>();
+	if (!ActorPoolSubsystem)
+	{
+		return nullptr;
+	}
+
+	return ActorPoolSubsystem->AcquireActor<ANexusAICharacter>(EnemyClass, SpawnTransform, nullptr, nullptr);
+}
+
+bool ANexusGameModeBase::FindEnemySpawnTransform_Implementation(FTransform& SpawnTransformOut)
+{
+	UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!bPlacePooledEnemiesNearPlayers || !NavigationSystem || !PooledEnemyClass)
+	{
+		return false;
+	}
+
+	// Enemies are placed around a random living player.
+	TArray<APawn*, TInlineAllocator<4>> PlayerPawns;
+	for (FConstPlayerControllerIterator PlayerIterator = GetWorld()->GetPlayerControllerIterator(); PlayerIterator; ++PlayerIterator)
+	{
+		APlayerController* PlayerController = PlayerIterator->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			PlayerPawns.Add(PlayerController->GetPawn());
+		}
+	}
+
+	if (0 == PlayerPawns.Num())
+	{
+		return false;
+	}
+
+	const APawn* PlayerPawn = PlayerPawns[FMath::RandRange(0, PlayerPawns.Num() - 1)];
+
+	FNavLocation SpawnLocation;
+	if (!NavigationSystem->GetRandomReachablePointInRadius(PlayerPawn->GetActorLocation(), EnemySpawnRadius, SpawnLocation))
+	{
+		return false;
+	}
+
+	// Navigation points are on the floor, so the enemy is raised by the height of its capsule.
+	const float CapsuleHalfHeight = PooledEnemyClass->GetDefaultObject<ANexusAICharacter>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	SpawnTransformOut = FTransform(FRotator(0.0f, FMath::FRandRange(-180.0f, 180.0f), 0.0f), SpawnLocation.Location + FVector(0.0f, 0.0f, CapsuleHalfHeight));
+	return true;
+}
+
+bool ANexusGameModeBase::IsPooledEnemyClass(const UClass* EnemyClass) const
+{
+	return PooledEnemyClass && EnemyClass == PooledEnemyClass;
+}
+
 void ANexusGameModeBase::CheckEnemiesAlive()
 {
 	// We should only check for alive enemies, if there are no enemies left to spawn and next wave timer is not active.
@@ -84,6 +149,13 @@ void ANexusGameModeBase::CheckEnemiesAlive()
 			// Check if the pawn is valid, and is not a player.
 			if (PawnToCheck && !PawnToCheck->IsPlayerControlled())
 			{
+				// Pooled enemies are not part of the wave.
+				const ANexusAICharacter* AICharacter = Cast<ANexusAICharacter>(PawnToCheck);
+				if (AICharacter && AICharacter->IsPooled())
+				{
+					continue;
+				}
+
 				UNexusHealthComponent* PawnHealthComponent = Cast<UNexusHealthComponent>(PawnToCheck->GetComponentByClass(UNexusHealthComponent::StaticClass()));
 				if (PawnHealthComponent && 0.0f < PawnHealthComponent->GetCurrentHealth())
 				{
@@ -172,8 +244,12 @@ void ANexusGameModeBase::EnemySpawnerElapsed()
 	// Only spawn an enemy if less than the max allowed on the map.
 	if (CurrentlySpawnedEnemies <= MaxEnemiesOnMap)
 	{
-		// Spawn an enemy
-		SpawnNewEnemy();
+		// Spawn an enemy. Pooled enemies placed natively are taken from the pool here, otherwise blueprint places the enemy and can reuse it with AcquireEnemy.
+		FTransform SpawnTransform;
+		if (!PooledEnemyClass || !FindEnemySpawnTransform(SpawnTransform) || !AcquireEnemy(PooledEnemyClass, SpawnTransform))
+		{
+			SpawnNewEnemy();
+		}
 
 		++CurrentlySpawnedEnemies;
 
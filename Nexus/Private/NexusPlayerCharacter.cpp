@@ -7,6 +7,82 @@
 #include "Kismet/GameplayStatics.h"
 #include "NexusPlayerState.h"
 #include "BulletDamageType.h"
+#include "Camera/CameraComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Face Cam Captures Active"), STAT_FaceCamCapturesActive, STATGROUP_Nexus);
+
+// Sets default values
+ANexusPlayerCharacter::ANexusPlayerCharacter()
+{
+	// Initialise the camera components
+	SpringArmComponent = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArmComponent"));
+	SpringArmComponent->bUsePawnControlRotation = true;
+	SpringArmComponent->SetupAttachment(RootComponent);
+
+	CameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("CameraComponent"));
+	CameraComponent->SetupAttachment(SpringArmComponent);
+
+	// The face cam is captured by a timer rather than every frame, and only activated for the local player.
+	CharacterCaptureComponent = CreateDefaultSubobject<USceneCaptureComponent2D>(TEXT("CharacterCaptureComponent"));
+	CharacterCaptureComponent->SetupAttachment(GetMesh(), FaceCamSocketName);
+	CharacterCaptureComponent->bCaptureEveryFrame = false;
+	CharacterCaptureComponent->bCaptureOnMovement = false;
+	CharacterCaptureComponent->bAutoActivate = false;
+}
+
+// Called every frame
+void ANexusPlayerCharacter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if !UE_SERVER
+	// Only the local player's camera zooms in when aiming down sights.
+	if (IsLocallyControlled())
+	{
+		SetAimDownSight(DeltaTime);
+	}
+#endif
+}
+
+// Called to bind functionality to input
+void ANexusPlayerCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+	PlayerInputComponent->BindAxis(MoveForwardBindingName, this, &ANexusPlayerCharacter::MoveForward);
+	PlayerInputComponent->BindAxis(MoveRightBindingName, this, &ANexusPlayerCharacter::MoveRight);
+
+	PlayerInputComponent->BindAxis(LookUpBindingName, this, &ANexusPlayerCharacter::AddControllerPitchInput);
+	PlayerInputComponent->BindAxis(TurnBindingName, this, &ANexusPlayerCharacter::AddControllerYawInput);
+
+	PlayerInputComponent->BindAction(CrouchBindingName, IE_Pressed, this, &ANexusPlayerCharacter::ToggleCrouch);
+
+	PlayerInputComponent->BindAction(JumpBindingName, IE_Pressed, this, &ANexusPlayerCharacter::Jump);
+
+	PlayerInputComponent->BindAction(AimingBindingName, IE_Pressed, this, &ANexusPlayerCharacter::StartADS);
+	PlayerInputComponent->BindAction(AimingBindingName, IE_Released, this, &ANexusPlayerCharacter::EndADS);
+
+	PlayerInputComponent->BindAction(ShootBindingName, IE_Pressed, this, &ANexusPlayerCharacter::StartShooting);
+	PlayerInputComponent->BindAction(ShootBindingName, IE_Released, this, &ANexusPlayerCharacter::StopShooting);
+
+	PlayerInputComponent->BindAction(ReloadBindingName, IE_Released, this, &ANexusPlayerCharacter::StartReloading);
+	
+	PlayerInputComponent->BindAction(SwapWeaponBindingName, IE_Released, this, &ANexusPlayerCharacter::InitiateWeaponSwap);
+}
+
+FVector ANexusPlayerCharacter::GetPawnViewLocation() const
+{
+	if (CameraComponent)
+	{
+		// View for character should be that of the 3rd person camera.
+		return CameraComponent->GetComponentLocation();
+	}
+
+	return Super::GetPawnViewLocation();
+}
 
 void ANexusPlayerCharacter::SwapWeapon()
 {
@@ -21,6 +97,9 @@ void ANexusPlayerCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Cache FOV so that we can reset when we stop ADS.
+	DefaultFOV = CameraComponent->FieldOfView;
+
 	APlayerController* PlayerController = GetController<APlayerController>();
 
 	if (PlayerController)
@@ -73,6 +152,14 @@ void ANexusPlayerCharacter::BeginPlay()
 	GetWorldTimerManager().SetTimer(TimerHandle_PlayerStart, this, &ANexusPlayerCharacter::DelayedPlayerStart, GameOverViewBlendTime);
 }
 
+// Called when the character is removed from the level
+void ANexusPlayerCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopFaceCam();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ANexusPlayerCharacter::HealthChanged(UNexusHealthComponent* HealthComponent, float Health, float HealthDelta, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
 {
 	Super::HealthChanged(HealthComponent, Health, HealthDelta, DamageType, InstigatedBy, DamageCauser);
@@ -82,6 +169,9 @@ void ANexusPlayerCharacter::HealthChanged(UNexusHealthComponent* HealthComponent
 	{
 		// Remove the HUD from the players screen.
 		CurrentHUDWidget->RemoveFromViewport();
+
+		// The face cam is only shown on the HUD.
+		StopFaceCam();
 		
 		APlayerController* PlayerController = GetController<APlayerController>();
 
@@ -119,9 +209,64 @@ void ANexusPlayerCharacter::DelayedPlayerStart()
 	{
 		// Add the HUD to the players screen.
 		CurrentHUDWidget->AddToViewport();
+
+		// Start capturing the face cam shown on the HUD.
+		StartFaceCam();
+	}
+}
+
+void ANexusPlayerCharacter::StartFaceCam()
+{
+	// Only the local player's HUD shows a face cam.
+	if (!IsLocallyControlled() || GetWorldTimerManager().IsTimerActive(TimerHandle_FaceCamCapture))
+	{
+		return;
+	}
+
+	CharacterCaptureComponent->Activate();
+
+	GetWorldTimerManager().SetTimer(TimerHandle_FaceCamCapture, this, &ANexusPlayerCharacter::CaptureFaceCam, 1.0f / FaceCamCaptureRate, true);
+
+	INC_DWORD_STAT(STAT_FaceCamCapturesActive);
+}
+
+void ANexusPlayerCharacter::StopFaceCam()
+{
+	if (GetWorldTimerManager().IsTimerActive(TimerHandle_FaceCamCapture))
+	{
+		GetWorldTimerManager().ClearTimer(TimerHandle_FaceCamCapture);
+
+		CharacterCaptureComponent->Deactivate();
+
+		DEC_DWORD_STAT(STAT_FaceCamCapturesActive);
+	}
+}
+
+bool ANexusPlayerCharacter::IsFaceCamVisible() const
+{
+	return CurrentHUDWidget && CurrentHUDWidget->IsInViewport() && CurrentHUDWidget->IsVisible();
+}
+
+void ANexusPlayerCharacter::CaptureFaceCam() const
+{
+	// The capture is paused while the face cam is not on screen.
+	if (CharacterCaptureComponent->TextureTarget && IsFaceCamVisible())
+	{
+		CharacterCaptureComponent->CaptureScene();
 	}
 }
 
+void ANexusPlayerCharacter::SetAimDownSight(float DeltaTime)
+{
+	// Interpolate the aim down sight for a smooth aim in/out.
+	
+	const float TargetFOV = IsAimingDownSights() ? AimingFOV : DefaultFOV;
+
+	const float InterpolationFOV = FMath::FInterpTo(CameraComponent->FieldOfView, TargetFOV, DeltaTime, ADSInterpolationSpeed);
+
+	CameraComponent->SetFieldOfView(InterpolationFOV);
+}
+
 void ANexusPlayerCharacter::PlayFlinchCameraShake()
 {
 	if(FlinchCameraShake)
@@ -9,6 +9,10 @@
 #include "Nexus/Utils/Logging/NexusLogging.h"
 #include "NexusCharacter.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
+#include "GameFramework/GameStateBase.h"
+#include "Subsystems/NexusLagCompensationSubsystem.h"
+#include "Subsystems/NexusImpactEffectSubsystem.h"
+#include "Subsystems/NexusTracerSubsystem.h"
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 #include "DrawDebugHelpers.h"
 #include "Nexus/Utils/ConsoleVariables.h"
@@ -36,18 +40,26 @@ ANexusWeapon::ANexusWeapon()
 void ANexusWeapon::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	if (bScheduledFireActive)
+	{
+		FireScheduledShots(DeltaTime);
+	}
 }
 
 void ANexusWeapon::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	// Replicate hit info on all clients except the owner, so the other clients can play the replicated weapon effects.
-	DOREPLIFETIME_CONDITION(ANexusWeapon, HitScanInfo, COND_SkipOwner);
+	// The owner plays its own fire cosmetics when it shoots, so the fire event is only needed by the other clients.
+	// Other clients reproduce each shot's traces from the shot sequence, instead of receiving its impacts.
+	DOREPLIFETIME_CONDITION(ANexusWeapon, FireEvent, COND_SkipOwner);
 
-	// Replicate ammo variables for weapon owner.
-	DOREPLIFETIME_CONDITION(ANexusWeapon, CurrentAmmoInClip, COND_OwnerOnly);
-	DOREPLIFETIME_CONDITION(ANexusWeapon, CurrentTotalAmmo, COND_OwnerOnly);
+	// The spread seed never changes, so is only sent with the initial replication.
+	DOREPLIFETIME_CONDITION(ANexusWeapon, SpreadSeed, COND_InitialOnly);
+
+	// Replicate ammo state for weapon owner.
+	DOREPLIFETIME_CONDITION(ANexusWeapon, AmmoAck, COND_OwnerOnly);
 
 	// Replicate the weapon owner. Required for animation replication.
 	DOREPLIFETIME(ANexusWeapon, OwningCharacter);
@@ -57,8 +69,116 @@ void ANexusWeapon::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLi
 
 void ANexusWeapon::StopFiring()
 {
-	// Stop looping timer to stop automatic fire.
-	GetWorldTimerManager().ClearTimer(TimerHandle_WeaponFireDelay);
+	// Stop scheduling automatic fire.
+	bScheduledFireActive = false;
+	bHasPreviousViewPoint = false;
+}
+
+void ANexusWeapon::StartScheduledFire()
+{
+	if (0.0f >= WeaponFireDelayTime)
+	{
+		return;
+	}
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// The first shot has to wait for the fire delay, so that the firing rate cannot be bypassed with rapid input.
+	NextScheduledShotTime = FMath::Max(LastFireTime + WeaponFireDelayTime, CurrentTime);
+	bScheduledFireActive = true;
+	bHasPreviousViewPoint = false;
+
+	// Fire straight away if the first shot is already due, rather than waiting for the next tick.
+	if (NextScheduledShotTime <= CurrentTime)
+	{
+		NextScheduledShotTime += WeaponFireDelayTime;
+
+		Fire();
+	}
+}
+
+void ANexusWeapon::FireScheduledShots(float DeltaTime)
+{
+	AActor* WeaponOwner = GetOwner();
+
+	if (!WeaponOwner)
+	{
+		StopFiring();
+		return;
+	}
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// The owner's view point is sampled once per frame. Shots between frames interpolate from the previous frame's view point.
+	FVector ViewLocation;
+	FRotator ViewRotator;
+	WeaponOwner->GetActorEyesViewPoint(ViewLocation, ViewRotator);
+	const FQuat ViewRotation = ViewRotator.Quaternion();
+
+	if (!bHasPreviousViewPoint)
+	{
+		PreviousViewLocation = ViewLocation;
+		PreviousViewRotation = ViewRotation;
+		bHasPreviousViewPoint = true;
+	}
+
+	if (NextScheduledShotTime <= CurrentTime)
+	{
+		// Shots beyond the per frame limit are dropped, rather than fired in one burst after a long hitch.
+		const int32 NumShotsOwed = FMath::FloorToInt((CurrentTime - NextScheduledShotTime) / WeaponFireDelayTime) + 1;
+		if (NumShotsOwed > MaxScheduledShotsPerFrame)
+		{
+			NextScheduledShotTime += (NumShotsOwed - MaxScheduledShotsPerFrame) * WeaponFireDelayTime;
+		}
+
+		const float FrameStartTime = CurrentTime - DeltaTime;
+
+		FWeaponScheduledShot ScheduledShot;
+		TGuardValue<const FWeaponScheduledShot*> ScheduledShotGuard(CurrentScheduledShot, &ScheduledShot);
+
+		// Firing can stop part way through the batch, e.g. when the clip runs dry.
+		while (bScheduledFireActive && NextScheduledShotTime <= CurrentTime)
+		{
+			const float Alpha = 0.0f < DeltaTime ? FMath::Clamp((NextScheduledShotTime - FrameStartTime) / DeltaTime, 0.0f, 1.0f) : 1.0f;
+
+			ScheduledShot.ShotTime = NextScheduledShotTime;
+			ScheduledShot.ViewLocation = FMath::Lerp(PreviousViewLocation, ViewLocation, Alpha);
+			ScheduledShot.ViewRotation = FQuat::Slerp(PreviousViewRotation, ViewRotation, Alpha).Rotator();
+			ScheduledShot.MuzzleOffset = ScheduledShot.ViewLocation - ViewLocation;
+
+			NextScheduledShotTime += WeaponFireDelayTime;
+
+			Fire();
+		}
+	}
+
+	PreviousViewLocation = ViewLocation;
+	PreviousViewRotation = ViewRotation;
+}
+
+void ANexusWeapon::GetShotViewPoint(AActor* WeaponOwner, FVector& ViewLocationOut, FRotator& ViewRotationOut) const
+{
+	if (CurrentScheduledShot)
+	{
+		ViewLocationOut = CurrentScheduledShot->ViewLocation;
+		ViewRotationOut = CurrentScheduledShot->ViewRotation;
+	}
+	else
+	{
+		WeaponOwner->GetActorEyesViewPoint(ViewLocationOut, ViewRotationOut);
+	}
+}
+
+FVector ANexusWeapon::GetShotMuzzleLocation() const
+{
+	const FVector MuzzleLocation = MeshComponent->GetSocketLocation(MuzzleSocketName);
+
+	return CurrentScheduledShot ? MuzzleLocation + CurrentScheduledShot->MuzzleOffset : MuzzleLocation;
+}
+
+float ANexusWeapon::GetShotTime() const
+{
+	return CurrentScheduledShot ? CurrentScheduledShot->ShotTime : GetWorld()->GetTimeSeconds();
 }
 
 void ANexusWeapon::StartReloading()
@@ -168,17 +288,15 @@ void ANexusWeapon::SetWeaponState(EWeaponState NewWeaponState)
 
 void ANexusWeapon::RestoreAmmo(int32 AmmoAmount)
 {
-	// Restore should only be called via the server authority.
+	// Restore should only be called via the server authority. The owning client predicts the result.
 	if (ROLE_Authority > GetLocalRole())
 	{
-		ServerReload();
+		ServerRestoreAmmo(AmmoAmount, PredictAmmoEvent(EAmmoEventType::Restore));
 	}
 
-	// Give full ammo.
-	CurrentTotalAmmo = MaxAmmo;
-	
-	// Fill clip ammo.
-	CurrentAmmoInClip = MaxAmmoPerClip;
+	ApplyAmmoEvent(EAmmoEventType::Restore);
+
+	UpdateAmmoAck();
 
 	// Publish UI update.
 	OnAmmoUpdated.Broadcast(this, CurrentAmmoInClip, GetAmmoInReserve());
@@ -189,12 +307,27 @@ void ANexusWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// The spread seed must be chosen before the weapon first replicates, as it is only sent with the initial replication.
+	if (ROLE_Authority == GetLocalRole())
+	{
+		SpreadSeed = FMath::Rand();
+	}
+
 	// Calculate the time between weapon shot. Rate of fire is round per minute.
 	WeaponFireDelayTime = 60.0f / WeaponRateOfFire;
 	// Initial ammo in clip should be somewhere between the max ammo the clip can hold, and the amount of ammo this weapon spawns with.
 	CurrentAmmoInClip = FMath::Min(MaxAmmoPerClip, StartingAmmo);
 	// The total available ammo should be the smallest amount between the spawn amount, and the maximum that can be carried.
 	CurrentTotalAmmo = FMath::Min(StartingAmmo, MaxAmmo);
+
+	UpdateAmmoAck();
+
+	// Create the pooled impact effects before the first shot.
+	UNexusImpactEffectSubsystem* ImpactEffectSubsystem = GetWorld()->GetSubsystem<UNexusImpactEffectSubsystem>();
+	if (ImpactEffectSubsystem)
+	{
+		ImpactEffectSubsystem->WarmPools();
+	}
 }
 
 bool ANexusWeapon::CanFireWeapon() const
@@ -213,23 +346,54 @@ bool ANexusWeapon::HasAmmoInClip() const
 	return 0 < CurrentAmmoInClip;
 }
 
-void ANexusWeapon::LineTraceForDamageAndImpactEffects(AActor* WeaponOwner, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut)
+void ANexusWeapon::LineTraceForDamageAndImpactEffects(AActor* WeaponOwner, FWeaponShotHits& ShotHits, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut)
+{
+	FVector TraceStart;
+	FVector TraceEnd;
+	FVector ShotDirection;
+
+	CalculateShotTrace(WeaponOwner, TraceStart, TraceEnd, ShotDirection);
+
+	BulletTracerTargetOut = TraceEnd;
+
+	SurfaceTypeOut = SurfaceType_Default;
+
+	FHitResult WeaponHitResult;
+	// Trace the world between the start and end locations. Returns true if blocking hit.
+	if (GetWorld()->LineTraceSingleByChannel(WeaponHitResult, TraceStart, TraceEnd, COLLISION_TRACE_WEAPON, GetWeaponTraceQueryParams(WeaponOwner)))
+	{
+		ResolveWeaponTraceHit(ShotHits, WeaponHitResult, ShotDirection, BulletTracerTargetOut, SurfaceTypeOut);
+	}
+}
+
+void ANexusWeapon::CalculateShotTrace(AActor* WeaponOwner, FVector& TraceStartOut, FVector& TraceEndOut, FVector& ShotDirectionOut) const
 {
 	// Start location for line trace.
-	FVector EyeLocation;
 	FRotator EyeRotation;
 
-	WeaponOwner->GetActorEyesViewPoint(EyeLocation, EyeRotation);
+	GetShotViewPoint(WeaponOwner, TraceStartOut, EyeRotation);
 
 	// Add "bullet spread" to shot direction. Shots are/can be more accurate while aiming down sights.
 	const float HalfAngleRad = OwningCharacter && OwningCharacter->IsAimingDownSights() ? FMath::DegreesToRadians(ADSBulletSpreadAngle)
 		: FMath::DegreesToRadians(BulletSpreadAngle);
-	FVector ShotDirection = FMath::VRandCone(EyeRotation.Vector(), HalfAngleRad);
+	// The spread stream is seeded per shot, so the owning client, the server and other clients derive the same direction.
+	ShotDirectionOut = ShotSpreadStream.VRandCone(EyeRotation.Vector(), HalfAngleRad);
 
 	// End location for eye trace.
-	FVector TraceEnd = EyeLocation + (ShotDirection * WeaponRange);
+	TraceEndOut = TraceStartOut + (ShotDirectionOut * WeaponRange);
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	const bool bDrawDebug = CVarDebugWeaponDrawing.GetValueOnGameThread();
+	if (bDrawDebug)
+	{
+		DrawDebugLine(GetWorld(), TraceStartOut, TraceEndOut, FColor::White, false, 1.0f, 0, 1.0f);
+	}
+#endif
+}
 
-	FCollisionQueryParams CollisionQueryParams;
+FCollisionQueryParams ANexusWeapon::GetWeaponTraceQueryParams(AActor* WeaponOwner) const
+{
+	FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(WeaponTrace));
 	// Ignore collisions with the weapon owner.
 	CollisionQueryParams.AddIgnoredActor(WeaponOwner);
 	// Ignore collisions with the weapon itself.
@@ -239,61 +403,240 @@ void ANexusWeapon::LineTraceForDamageAndImpactEffects(AActor* WeaponOwner, FVect
 	// Ensure that the surface material is returned to check what body part was hit.
 	CollisionQueryParams.bReturnPhysicalMaterial = true;
 
-	BulletTracerTargetOut = TraceEnd;
+	return CollisionQueryParams;
+}
 
-	SurfaceTypeOut = SurfaceType_Default;
+void ANexusWeapon::ResolveWeaponTraceHit(FWeaponShotHits& ShotHits, const FHitResult& WeaponHitResult, const FVector& ShotDirection, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut)
+{
+	// Get the surface type that was hit.
+	SurfaceTypeOut = UPhysicalMaterial::DetermineSurfaceType(WeaponHitResult.PhysMaterial.Get());
 
-	FHitResult WeaponHitResult;
-	// Trace the world between the start and end locations. Returns true if blocking hit.
-	if (GetWorld()->LineTraceSingleByChannel(WeaponHitResult, EyeLocation, TraceEnd, COLLISION_TRACE_WEAPON, CollisionQueryParams))
+	// Calculate the amount of damage to inflict. It is applied once the whole shot has resolved.
+	const float DamageToInflict = WeaponDamage * GetDamageMultiplier(SurfaceTypeOut);
+
+	ShotHits.AddHit(WeaponHitResult, SurfaceTypeOut, ShotDirection, DamageToInflict);
+
+	// Every hit gets its own impact particle effect. The impact sound is played once per shot.
+	PlayImpactEffect(SurfaceTypeOut, WeaponHitResult.ImpactPoint);
+
+	// If the shot hit something, the bullet tracer target should be updated.
+	BulletTracerTargetOut = WeaponHitResult.ImpactPoint;
+}
+
+void ANexusWeapon::FireHitScanTraces(AActor* WeaponOwner, int32 NumTraces)
+{
+	// Bullet tracer target parameter.
+	FVector BulletTracerTarget;
+	// The type of surface that was hit. Used to add damage multiplier and play different effects.
+	EPhysicalSurface SurfaceType = SurfaceType_Default;
+	// Hits are gathered, so that each actor hit receives one combined damage event.
+	FWeaponShotHits ShotHits;
+
+	// Fire a line trace to act as each "bullet" in the shot.
+	for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
 	{
-		AActor* HitActor = WeaponHitResult.GetActor();
+		LineTraceForDamageAndImpactEffects(WeaponOwner, ShotHits, BulletTracerTarget, SurfaceType);
+	}
 
-		// Get the surface type that was hit.
-		SurfaceTypeOut = UPhysicalMaterial::DetermineSurfaceType(WeaponHitResult.PhysMaterial.Get());
+	ApplyShotHits(WeaponOwner, ShotHits);
 
-		// Calculate the amount of damage to inflict.
-		float DamageToInflict = WeaponDamage * GetDamageMultiplier(SurfaceTypeOut);
+	// Play weapon effects locally. Other clients reproduce the shot from the replicated fire event.
+	PlayWeaponFiredEffects(BulletTracerTarget);
+}
 
-		// Apply damage to the hit actor.
-		UGameplayStatics::ApplyPointDamage(HitActor, DamageToInflict, ShotDirection, WeaponHitResult,
-			WeaponOwner->GetInstigatorController(), this, DamageType);
+void ANexusWeapon::PlaySimulatedHitScanTraces(AActor* WeaponOwner, int32 NumTraces)
+{
+	const FCollisionQueryParams CollisionQueryParams = GetWeaponTraceQueryParams(WeaponOwner);
+
+	for (int32 TraceIndex = 0; TraceIndex < NumTraces; ++TraceIndex)
+	{
+		FVector TraceStart;
+		FVector TraceEnd;
+		FVector ShotDirection;
 
-		// Play weapon impact effects locally.
-		PlayWeaponImpactEffects(SurfaceTypeOut, WeaponHitResult.ImpactPoint);
+		CalculateShotTrace(WeaponOwner, TraceStart, TraceEnd, ShotDirection);
 
-		// If the shot hit something, the bullet tracer target should be updated.
-		BulletTracerTargetOut = WeaponHitResult.ImpactPoint;
+		FHitResult WeaponHitResult;
+		if (GetWorld()->LineTraceSingleByChannel(WeaponHitResult, TraceStart, TraceEnd, COLLISION_TRACE_WEAPON, CollisionQueryParams))
+		{
+			PlayBulletTracerEffect(WeaponHitResult.ImpactPoint);
+
+			PlayWeaponImpactEffects(UPhysicalMaterial::DetermineSurfaceType(WeaponHitResult.PhysMaterial.Get()), WeaponHitResult.ImpactPoint);
+		}
+		else
+		{
+			PlayBulletTracerEffect(TraceEnd);
+		}
 	}
+}
 
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
-	const bool bDrawDebug = CVarDebugWeaponDrawing.GetValueOnGameThread();
-	if (bDrawDebug)
+void ANexusWeapon::ApplyShotHits(AActor* WeaponOwner, const FWeaponShotHits& ShotHits)
+{
+	AController* InstigatorController = WeaponOwner ? WeaponOwner->GetInstigatorController() : nullptr;
+
+	const FWeaponHitGroup* ImpactCueGroup = nullptr;
+	int32 ImpactCuePriority = INDEX_NONE;
+
+	for (int32 GroupIndex = 0; GroupIndex < ShotHits.HitGroups.Num(); ++GroupIndex)
 	{
-		DrawDebugLine(GetWorld(), EyeLocation, TraceEnd, FColor::White, false, 1.0f, 0, 1.0f);
+		const FWeaponHitGroup& HitGroup = ShotHits.HitGroups[GroupIndex];
+
+		// The impact cue is played for the most significant surface hit by the shot.
+		const int32 SurfacePriority = SURFACE_CHARACTER_HEAD == HitGroup.SurfaceType ? 3
+			: SURFACE_CHARACTER_BODY == HitGroup.SurfaceType ? 2
+			: SURFACE_CHARACTER_LIMBS == HitGroup.SurfaceType ? 1 : 0;
+
+		if (SurfacePriority > ImpactCuePriority)
+		{
+			ImpactCueGroup = &HitGroup;
+			ImpactCuePriority = SurfacePriority;
+		}
+
+		AActor* HitActor = HitGroup.HitActor.Get();
+
+		if (!HitActor)
+		{
+			continue;
+		}
+
+		// Damage for an actor is applied by its first group, so skip actors that have already been handled.
+		bool bActorAlreadyDamaged = false;
+
+		for (int32 PreviousGroupIndex = 0; PreviousGroupIndex < GroupIndex; ++PreviousGroupIndex)
+		{
+			if (ShotHits.HitGroups[PreviousGroupIndex].HitActor.Get() == HitActor)
+			{
+				bActorAlreadyDamaged = true;
+				break;
+			}
+		}
+
+		if (bActorAlreadyDamaged)
+		{
+			continue;
+		}
+
+		// Combine the damage from every surface of this actor that was hit. The hit info is taken from the most damaging group.
+		float TotalDamage = 0.0f;
+		const FWeaponHitGroup* DamageGroup = &HitGroup;
+
+		for (int32 ActorGroupIndex = GroupIndex; ActorGroupIndex < ShotHits.HitGroups.Num(); ++ActorGroupIndex)
+		{
+			const FWeaponHitGroup& ActorGroup = ShotHits.HitGroups[ActorGroupIndex];
+
+			if (ActorGroup.HitActor.Get() == HitActor)
+			{
+				TotalDamage += ActorGroup.Damage;
+
+				if (ActorGroup.Damage > DamageGroup->Damage)
+				{
+					DamageGroup = &ActorGroup;
+				}
+			}
+		}
+
+		// Apply damage to the hit actor.
+		UGameplayStatics::ApplyPointDamage(HitActor, TotalDamage, DamageGroup->ShotDirection, DamageGroup->HitResult,
+			InstigatorController, this, DamageType);
+	}
+
+	if (ImpactCueGroup)
+	{
+		PlayImpactSFX(ImpactCueGroup->SurfaceType, ImpactCueGroup->HitResult.ImpactPoint);
 	}
-#endif
 }
 
-void ANexusWeapon::ServerFire_Implementation()
+void ANexusWeapon::ServerFire_Implementation(float ClientFireTime, uint16 AmmoEventId, uint16 ShotSequence)
 {
+	// Continue from the client's shot sequence, so the server derives the same spread as the client. The client is ahead when the server rejected
+	// some of its shots, but never by more than a few. Any other sequence would let the client choose its spread, so the server keeps its own.
+	const uint16 ShotsAhead = ShotSequence - NextShotSequence;
+	if (ShotsAhead <= MaxShotSequenceSkip)
+	{
+		NextShotSequence = ShotSequence;
+	}
+
+	// A bad fire time from the client is not rewound, rather than rejected, so the client is not disconnected.
+	const float ServerWorldTime = GetServerWorldTime();
+	const float RewindTime = FMath::IsFinite(ClientFireTime) && 0.0f <= ClientFireTime ? FMath::Min(ClientFireTime, ServerWorldTime) : ServerWorldTime;
+
+	// Rewind hit volumes to where the client saw them when it fired, so shots that hit on the client also hit on the server.
+	FNexusScopedLagCompensation ScopedLagCompensation(GetWorld(), RewindTime, GetOwner());
+
+	TGuardValue<bool> LagCompensatedShotGuard(bLagCompensatedShot, true);
+
 	// The shoot code will execute via the server authority.
 	Fire();
+
+	// Acknowledge the shot even if the server rejected it, so the client stops predicting it.
+	AcknowledgeAmmoEvent(AmmoEventId);
 }
 
-bool ANexusWeapon::ServerFire_Validate()
+bool ANexusWeapon::ServerFire_Validate(float ClientFireTime, uint16 AmmoEventId, uint16 ShotSequence)
 {
 	return true;
 }
 
-void ANexusWeapon::OnRep_HitScanInfo()
+float ANexusWeapon::GetServerWorldTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+void ANexusWeapon::OnRep_FireEvent()
+{
+	// The first fire event received holds shots fired before the weapon became relevant, so they are not played.
+	if (!bFireEventReceived)
+	{
+		bFireEventReceived = true;
+		LastSimulatedFireCount = FireEvent.FireCount;
+		return;
+	}
+
+	// Shots fired between net updates are collapsed into one, as only the latest fire event is replicated.
+	PlayMuzzleEffect();
+
+	PlayFireCosmetics(FireEvent.bAimingDownSights);
+
+	// Shots have consecutive sequence numbers, so every shot since the last update can be reproduced from the latest sequence.
+	const int32 NumTraces = GetHitScanTracesPerShot();
+	if (0 < NumTraces && OwningCharacter)
+	{
+		const uint8 NumNewShots = FireEvent.FireCount - LastSimulatedFireCount;
+		const int32 NumShotsToPlay = FMath::Min<int32>(NumNewShots, MaxSimulatedShotsPerUpdate);
+
+		for (int32 ShotIndex = NumShotsToPlay - 1; ShotIndex >= 0; --ShotIndex)
+		{
+			SeedShotSpread(FireEvent.ShotSequence - ShotIndex);
+
+			PlaySimulatedHitScanTraces(OwningCharacter, NumTraces);
+		}
+	}
+
+	LastSimulatedFireCount = FireEvent.FireCount;
+}
+
+void ANexusWeapon::RecordFireEvent(uint16 ShotSequence)
 {
-	// This method is called when HitScanInfo is replicated.
+	if (ROLE_Authority == GetLocalRole())
+	{
+		++FireEvent.FireCount;
+		FireEvent.bAimingDownSights = OwningCharacter && OwningCharacter->IsAimingDownSights();
+		FireEvent.ShotSequence = ShotSequence;
+	}
+}
 
-	// When the information is replicated to the other clients, they should use it to play the weapon effects.
-	PlayWeaponFiredEffects(HitScanInfo.TraceTargetLocation);
+void ANexusWeapon::SeedShotSpread(uint16 ShotSequence)
+{
+	ShotSpreadStream.Initialize(static_cast<int32>(HashCombine(static_cast<uint32>(SpreadSeed), ShotSequence)));
+}
+
+void ANexusWeapon::PlayFireCosmetics(bool bAimingDownSights) const
+{
+	PlayFiredSFX();
 
-	PlayWeaponImpactEffects(HitScanInfo.HitSurfaceType, HitScanInfo.TraceTargetLocation);
+	PlayFiredAnimation(bAimingDownSights);
 }
 
 bool ANexusWeapon::CanReloadWeapon()
@@ -310,26 +653,15 @@ bool ANexusWeapon::CanReloadWeapon()
 
 void ANexusWeapon::Reload()
 {
-	// Reload should only be called via the server authority.
+	// Reload should only be called via the server authority. The owning client predicts the result.
 	if (ROLE_Authority > GetLocalRole())
 	{
-		ServerReload();
+		ServerReload(PredictAmmoEvent(EAmmoEventType::Reload));
 	}
-	
-	// Calculate how much room is in the clip.
-	const int32 BulletsDepletedFromClip = MaxAmmoPerClip - CurrentAmmoInClip;
-
-	// Calculate how much ammo is spare that is not in the clip.
-	const int32 BulletsInReserve = CurrentTotalAmmo - CurrentAmmoInClip;
 
-	// The amount of bullets to reload should be the smallest amount between available bullets, and room in clip.
-	const int32 BulletsToReload = FMath::Min(BulletsDepletedFromClip, BulletsInReserve);
+	ApplyAmmoEvent(EAmmoEventType::Reload);
 
-	if (0 < BulletsToReload)
-	{
-		// Add bullets to clip.
-		CurrentAmmoInClip += BulletsToReload;
-	}
+	UpdateAmmoAck();
 
 	OnAmmoUpdated.Broadcast(this, CurrentAmmoInClip, GetAmmoInReserve());
 
@@ -337,27 +669,125 @@ void ANexusWeapon::Reload()
 	SetWeaponState(EWeaponState::Idle);
 }
 
-void ANexusWeapon::ServerRestoreAmmo_Implementation(int32 AmmoAmount)
+void ANexusWeapon::ServerRestoreAmmo_Implementation(int32 AmmoAmount, uint16 AmmoEventId)
 {
 	RestoreAmmo(AmmoAmount);
+
+	AcknowledgeAmmoEvent(AmmoEventId);
 }
 
-bool ANexusWeapon::ServerRestoreAmmo_Validate(int32 AmmoAmount)
+bool ANexusWeapon::ServerRestoreAmmo_Validate(int32 AmmoAmount, uint16 AmmoEventId)
 {
 	return true;
 }
 
-void ANexusWeapon::ServerReload_Implementation()
+void ANexusWeapon::ServerReload_Implementation(uint16 AmmoEventId)
 {
 	// The reload code will execute via the server authority.
 	Reload();
+
+	AcknowledgeAmmoEvent(AmmoEventId);
 }
 
-bool ANexusWeapon::ServerReload_Validate()
+bool ANexusWeapon::ServerReload_Validate(uint16 AmmoEventId)
 {
 	return true;
 }
 
+void ANexusWeapon::OnRep_AmmoAck()
+{
+	// This method is called on the owning client when the server's ammo state is replicated.
+
+	// Drop the events the server has processed. Event ids wrap, so compare the signed difference.
+	const uint16 LastEventId = AmmoAck.LastEventId;
+	PendingAmmoEvents.RemoveAll([LastEventId](const FPredictedAmmoEvent& PendingEvent)
+	{
+		return 0 >= static_cast<int16>(PendingEvent.EventId - LastEventId);
+	});
+
+	// Roll back to the server state, then replay the events still in flight.
+	CurrentAmmoInClip = AmmoAck.AmmoInClip;
+	CurrentTotalAmmo = AmmoAck.TotalAmmo;
+
+	for (const FPredictedAmmoEvent& PendingEvent : PendingAmmoEvents)
+	{
+		ApplyAmmoEvent(PendingEvent.EventType);
+	}
+
+	OnAmmoUpdated.Broadcast(this, CurrentAmmoInClip, GetAmmoInReserve());
+}
+
+uint16 ANexusWeapon::PredictAmmoEvent(EAmmoEventType EventType)
+{
+	if (MaxPendingAmmoEvents <= PendingAmmoEvents.Num())
+	{
+		PendingAmmoEvents.RemoveAt(0, PendingAmmoEvents.Num() - MaxPendingAmmoEvents + 1, false);
+	}
+
+	FPredictedAmmoEvent& PendingEvent = PendingAmmoEvents.AddDefaulted_GetRef();
+	PendingEvent.EventId = NextAmmoEventId++;
+	PendingEvent.EventType = EventType;
+
+	return PendingEvent.EventId;
+}
+
+void ANexusWeapon::AcknowledgeAmmoEvent(uint16 AmmoEventId)
+{
+	if (ROLE_Authority == GetLocalRole())
+	{
+		AmmoAck.LastEventId = AmmoEventId;
+
+		UpdateAmmoAck();
+	}
+}
+
+void ANexusWeapon::UpdateAmmoAck()
+{
+	if (ROLE_Authority == GetLocalRole())
+	{
+		AmmoAck.AmmoInClip = CurrentAmmoInClip;
+		AmmoAck.TotalAmmo = CurrentTotalAmmo;
+	}
+}
+
+void ANexusWeapon::ApplyAmmoEvent(EAmmoEventType EventType)
+{
+	switch (EventType)
+	{
+		case EAmmoEventType::Shot:
+			CurrentAmmoInClip = FMath::Max(0, CurrentAmmoInClip - 1);
+			CurrentTotalAmmo = FMath::Max(0, CurrentTotalAmmo - 1);
+			break;
+		case EAmmoEventType::Reload:
+		{
+			// Calculate how much room is in the clip.
+			const int32 BulletsDepletedFromClip = MaxAmmoPerClip - CurrentAmmoInClip;
+
+			// Calculate how much ammo is spare that is not in the clip.
+			const int32 BulletsInReserve = CurrentTotalAmmo - CurrentAmmoInClip;
+
+			// The amount of bullets to reload should be the smallest amount between available bullets, and room in clip.
+			const int32 BulletsToReload = FMath::Min(BulletsDepletedFromClip, BulletsInReserve);
+
+			if (0 < BulletsToReload)
+			{
+				// Add bullets to clip.
+				CurrentAmmoInClip += BulletsToReload;
+			}
+			break;
+		}
+		case EAmmoEventType::Restore:
+			// Give full ammo.
+			CurrentTotalAmmo = MaxAmmo;
+
+			// Fill clip ammo.
+			CurrentAmmoInClip = MaxAmmoPerClip;
+			break;
+		default:
+			break;
+	}
+}
+
 void ANexusWeapon::ServerPlayAnimationMontage_Implementation(UAnimMontage* AnimMontage, float PlaybackRate)
 {
 	// To get something to execute on all clients (and the server), you need to use a NetMulticast function, that is called from the server.
@@ -383,50 +813,35 @@ void ANexusWeapon::MulticastPlaySFX_Implementation(USoundBase* SoundEffect)
 	UGameplayStatics::SpawnSoundAttached(SoundEffect, MeshComponent);
 }
 
-void ANexusWeapon::ServerPlaySFXAtLocation_Implementation(USoundBase* SoundEffect, FVector Location)
-{
-	MulticastPlaySFXAtLocation(SoundEffect, Location);
-}
-
-void ANexusWeapon::MulticastPlaySFXAtLocation_Implementation(USoundBase* SoundEffect, FVector Location)
-{
-	UGameplayStatics::SpawnSoundAtLocation(this, SoundEffect, Location);
-}
-
 void ANexusWeapon::PlayWeaponImpactEffects(EPhysicalSurface SurfaceType, FVector Target)
 {
 	// Spawn particle effect for weapon impact.
 	PlayImpactEffect(SurfaceType, Target);
+
+	// Spawn sound effect for weapon impact.
+	PlayImpactSFX(SurfaceType, Target);
 }
 
 void ANexusWeapon::PlayImpactEffect(EPhysicalSurface SurfaceType, FVector Target)
 {
-	// Set the impact vfx/sfx to be played depending on the surface type that is hit.
+	// Set the impact vfx to be played depending on the surface type that is hit.
 	UParticleSystem* SurfaceImpactVFX = nullptr;
 
-	USoundBase* SurfaceImpactSFX = nullptr;
-
 	switch (SurfaceType)
 	{
 		case SURFACE_CHARACTER_HEAD:
-			SurfaceImpactVFX = CharacterImpactVFX;
-			SurfaceImpactSFX = HeadshotImpactSFX;
-			break;
 		case SURFACE_CHARACTER_BODY:
-			SurfaceImpactVFX = CharacterImpactVFX;
-			SurfaceImpactSFX = BodyImpactSFX;
-			break;
 		case SURFACE_CHARACTER_LIMBS:
 			SurfaceImpactVFX = CharacterImpactVFX;
-			SurfaceImpactSFX = LimbImpactSFX;
 			break;
 		default:
 			SurfaceImpactVFX = DefaultImpactVFX;
 			break;
 	}
 
-	// Spawn particle effect for impact.
-	if (SurfaceImpactVFX)
+	// Spawn particle effect for impact. The impact effect subsystem does not exist on a dedicated server.
+	UNexusImpactEffectSubsystem* ImpactEffectSubsystem = GetWorld()->GetSubsystem<UNexusImpactEffectSubsystem>();
+	if (SurfaceImpactVFX && ImpactEffectSubsystem)
 	{
 		const FVector MuzzleLocation = MeshComponent->GetSocketLocation(MuzzleSocketName);
 
@@ -434,22 +849,34 @@ void ANexusWeapon::PlayImpactEffect(EPhysicalSurface SurfaceType, FVector Target
 		FVector ShotDirection = Target - MuzzleLocation;
 		ShotDirection.Normalize();
 		
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), SurfaceImpactVFX, Target, ShotDirection.Rotation());
+		ImpactEffectSubsystem->PlayImpactEffect(SurfaceImpactVFX, SurfaceType, Target, ShotDirection.Rotation());
 	}
-	
-	// Spawn sound effect for impact.
+}
+
+void ANexusWeapon::PlayImpactSFX(EPhysicalSurface SurfaceType, FVector Target)
+{
+	// Set the impact sfx to be played depending on the surface type that is hit.
+	USoundBase* SurfaceImpactSFX = nullptr;
+
+	switch (SurfaceType)
+	{
+		case SURFACE_CHARACTER_HEAD:
+			SurfaceImpactSFX = HeadshotImpactSFX;
+			break;
+		case SURFACE_CHARACTER_BODY:
+			SurfaceImpactSFX = BodyImpactSFX;
+			break;
+		case SURFACE_CHARACTER_LIMBS:
+			SurfaceImpactSFX = LimbImpactSFX;
+			break;
+		default:
+			break;
+	}
+
+	// Spawn sound effect for impact. The shooter plays it from its own trace, other clients play it when they replay the shot from FireEvent's shot sequence.
 	if (SurfaceImpactSFX)
 	{
-		if (ROLE_Authority > GetLocalRole())
-		{
-			// Play the sfx via the server authority.
-			ServerPlaySFXAtLocation(SurfaceImpactSFX, Target);
-		}
-		else
-		{
-			// Play the sfx.
-			MulticastPlaySFXAtLocation(SurfaceImpactSFX, Target);
-		}
+		UGameplayStatics::SpawnSoundAtLocation(this, SurfaceImpactSFX, Target);
 	}	
 }
 
@@ -476,9 +903,15 @@ void ANexusWeapon::PlayMuzzleEffect() const
 
 void ANexusWeapon::PlayBulletTracerEffect(FVector BulletTracerTarget) const
 {
-	if (TracerVFX)
+	// Tracer meshes are drawn by the batched tracer renderer, instead of spawning an emitter per shot. It does not exist on a dedicated server.
+	UNexusTracerSubsystem* TracerSubsystem = GetWorld()->GetSubsystem<UNexusTracerSubsystem>();
+	if (TracerMesh && TracerSubsystem)
 	{
-		const FVector MuzzleLocation = MeshComponent->GetSocketLocation(MuzzleSocketName);
+		TracerSubsystem->AddTracer(TracerMesh, TracerMaterial, GetShotMuzzleLocation(), BulletTracerTarget);
+	}
+	else if (TracerVFX && !TracerMesh)
+	{
+		const FVector MuzzleLocation = GetShotMuzzleLocation();
 
 		UParticleSystemComponent* TracerComponent = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), TracerVFX, MuzzleLocation);
 
@@ -506,20 +939,11 @@ void ANexusWeapon::PlayCameraShake() const
 	}	
 }
 
-void ANexusWeapon::PlayFiredSFX()
+void ANexusWeapon::PlayFiredSFX() const
 {
 	if (FiredSFX)
 	{
-		if (ROLE_Authority > GetLocalRole())
-		{
-			// Play the sfx via the server authority.
-			ServerPlaySFX(FiredSFX);
-		}
-		else
-		{
-			// Play the sfx.
-			MulticastPlaySFX(FiredSFX);
-		}
+		UGameplayStatics::SpawnSoundAttached(FiredSFX, MeshComponent);
 	}
 }
 
@@ -540,25 +964,16 @@ void ANexusWeapon::PlayDryFiredSFX()
 	}
 }
 
-void ANexusWeapon::PlayFiredAnimation()
+void ANexusWeapon::PlayFiredAnimation(bool bAimingDownSights) const
 {
-	// Play reload animation.
-	UAnimMontage* FireAnimMontage = OwningCharacter->IsAimingDownSights() ? ADSFireAnimMontage : HipFireAnimMontage;
+	// Play fire animation.
+	UAnimMontage* FireAnimMontage = bAimingDownSights ? ADSFireAnimMontage : HipFireAnimMontage;
 
-	if (FireAnimMontage)
+	if (FireAnimMontage && OwningCharacter)
 	{
 		const float FireMontagePlaybackRate = FireAnimMontage->GetPlayLength() / WeaponFireDelayTime;
 
-		if (ROLE_Authority > GetLocalRole())
-		{
-			// Play the animation via the server authority.
-			ServerPlayAnimationMontage(FireAnimMontage, FireMontagePlaybackRate);
-		}
-		else
-		{
-			// Play the animation.
-			MulticastPlayAnimationMontage(FireAnimMontage, FireMontagePlaybackRate);
-		}
+		OwningCharacter->PlayAnimMontage(FireAnimMontage, FireMontagePlaybackRate);
 	}
 }
 
@@ -579,8 +994,9 @@ float ANexusWeapon::GetDamageMultiplier(EPhysicalSurface SurfaceType) const
 
 void ANexusWeapon::DepleteAmmo()
 {
-	CurrentAmmoInClip = FMath::Max(0, --CurrentAmmoInClip);
-	CurrentTotalAmmo = FMath::Max(0, --CurrentTotalAmmo);
+	ApplyAmmoEvent(EAmmoEventType::Shot);
+
+	UpdateAmmoAck();
 
 	OnAmmoUpdated.Broadcast(this, CurrentAmmoInClip, GetAmmoInReserve());
 	
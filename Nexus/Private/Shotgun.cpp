@@ -1,72 +1,117 @@
 // Toyan Green © 2020
 
 #include "Shotgun.h"
-#include "NexusCharacter.h"
-#include "PhysicalMaterials/PhysicalMaterial.h"
-#include "Kismet/GameplayStatics.h"
+#include "NexusWeaponFirePolicies.h"
+#include "Nexus/Utils/NexusTypeDefinitions.h"
+#include "Nexus/Utils/NexusStats.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shotgun Pellet Traces"), STAT_ShotgunPelletTraces, STATGROUP_Nexus);
+DECLARE_CYCLE_STAT(TEXT("Shotgun Pellet Resolve"), STAT_ShotgunPelletResolve, STATGROUP_Nexus);
 
 void AShotgun::StartFiring()
 {
-	// Weapon should fire once, if the time elapsed since the last shot is greater than the fire delay.
-	if (GetWorld()->GetTimeSeconds() >= LastFireTime + WeaponFireDelayTime)
+	StartFiringWithPolicy<FSemiAutomaticTriggerPolicy>();
+}
+
+void AShotgun::BeginPlay()
+{
+	Super::BeginPlay();
+
+	PelletTraceDelegate.BindUObject(this, &AShotgun::OnPelletTraceCompleted);
+}
+
+void AShotgun::Fire()
+{
+	FireWithPolicies<FSemiAutomaticTriggerPolicy, FPelletShotPolicy, AShotgun>();
+}
+
+void AShotgun::FirePellets(AActor* WeaponOwner)
+{
+	INC_DWORD_STAT_BY(STAT_ShotgunPelletTraces, NumberOfPelletsInShot);
+
+	// Lag compensated shots must trace while the world is rewound, so cannot wait for async results.
+	if (bUseAsyncPelletTraces && !bLagCompensatedShot)
+	{
+		// Pellet damage, impacts and the bullet tracer are resolved when the trace results arrive.
+		FirePelletsAsync(WeaponOwner);
+
+		PlayMuzzleEffect();
+
+		PlayCameraShake();
+	}
+	else
 	{
-		Fire();
+		FireHitScanTraces(WeaponOwner, NumberOfPelletsInShot);
 	}
 }
 
-void AShotgun::Fire()
+void AShotgun::FirePelletsAsync(AActor* WeaponOwner)
+{
+	FPendingPelletShot& PendingShot = PendingPelletShots.AddDefaulted_GetRef();
+	PendingShot.ShotId = NextPelletShotId++;
+	PendingShot.PelletsRemaining = NumberOfPelletsInShot;
+	PendingShot.SurfaceType = SurfaceType_Default;
+
+	const FCollisionQueryParams CollisionQueryParams = GetWeaponTraceQueryParams(WeaponOwner);
+
+	for (int i = 0; i < NumberOfPelletsInShot; ++i)
+	{
+		FVector TraceStart;
+		FVector TraceEnd;
+		FVector ShotDirection;
+
+		CalculateShotTrace(WeaponOwner, TraceStart, TraceEnd, ShotDirection);
+
+		// Until the pellet resolves, the tracer should target the end of the trace.
+		PendingShot.BulletTracerTarget = TraceEnd;
+
+		// The results are gathered with the rest of the frame's async traces, and delivered at the start of the next frame.
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, COLLISION_TRACE_WEAPON, CollisionQueryParams,
+			FCollisionResponseParams::DefaultResponseParam, &PelletTraceDelegate, PendingShot.ShotId);
+	}
+}
+
+void AShotgun::OnPelletTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
 {
-	AActor* WeaponOwner = GetOwner();
+	SCOPE_CYCLE_COUNTER(STAT_ShotgunPelletResolve);
+
+	const int32 PendingShotIndex = PendingPelletShots.IndexOfByPredicate([&TraceDatum](const FPendingPelletShot& PendingShot)
+	{
+		return PendingShot.ShotId == TraceDatum.UserData;
+	});
+
+	if (INDEX_NONE == PendingShotIndex)
+	{
+		return;
+	}
+
+	FPendingPelletShot& PendingShot = PendingPelletShots[PendingShotIndex];
 
-	if (WeaponOwner && CanFireWeapon())
+	if (0 < TraceDatum.OutHits.Num() && TraceDatum.OutHits[0].bBlockingHit)
 	{
-		if (!HasAmmoInClip())
-		{
-			// There is no ammo loaded in the clip, so the weapon should dry fire.
-			PlayDryFiredSFX();
-			StopFiring();
-		}
-		else
-		{
-			SetWeaponState(EWeaponState::Firing);
-		
-			// Fire should only be called via the server authority.
-			if (ROLE_Authority > GetLocalRole())
-			{
-				ServerFire();
-			}
-
-			// Use ammo.
-			DepleteAmmo();
-			
-			// Bullet tracer target parameter.
-			FVector BulletTracerTarget;
-			// The type of surface that was hit. Used to add damage multiplier and play different effects.
-			EPhysicalSurface SurfaceType = SurfaceType_Default;
-
-			// Fire a line trace to act as each "pellet" in the shot
-			for (int i = 1; i < NumberOfPelletsInShot; ++i)
-			{
-				LineTraceForDamageAndImpactEffects(WeaponOwner, BulletTracerTarget, SurfaceType);
-			}
-
-			// Play weapon effects locally.
-			PlayWeaponFiredEffects(BulletTracerTarget);
-
-			PlayFiredSFX();
-
-			PlayFiredAnimation();
-
-			// The server authority should replicate the hit scan information, so clients can replicate the weapon effects.
-			if (GetLocalRole() == ROLE_Authority)
-			{
-				HitScanInfo.TraceTargetLocation = BulletTracerTarget;
-				HitScanInfo.HitSurfaceType = SurfaceType;
-			}
-		
-			// This needs to be set to prevent the firing rate getting bypassed with rapid firing input.
-			LastFireTime = GetWorld()->GetTimeSeconds();
-		}
+		const FVector ShotDirection = (TraceDatum.End - TraceDatum.Start).GetSafeNormal();
+
+		ResolveWeaponTraceHit(PendingShot.ShotHits, TraceDatum.OutHits[0], ShotDirection, PendingShot.BulletTracerTarget, PendingShot.SurfaceType);
+	}
+	else
+	{
+		PendingShot.BulletTracerTarget = TraceDatum.End;
+		PendingShot.SurfaceType = SurfaceType_Default;
 	}
+
+	if (0 == --PendingShot.PelletsRemaining)
+	{
+		FinishPelletShot(PendingShot);
+
+		PendingPelletShots.RemoveAt(PendingShotIndex);
+	}
+}
+
+void AShotgun::FinishPelletShot(const FPendingPelletShot& PendingShot)
+{
+	// Each actor hit by the shot receives one combined damage event.
+	ApplyShotHits(GetOwner(), PendingShot.ShotHits);
+
+	// The muzzle flash and camera shake were played when the shot was fired.
+	PlayBulletTracerEffect(PendingShot.BulletTracerTarget);
 }
@@ -0,0 +1,127 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusActorPoolSubsystem.h"
+#include "Interfaces/NexusPoolableActor.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Pool Reused"), STAT_ActorPoolReused, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actor Pool Spawned"), STAT_ActorPoolSpawned, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Actor Pool Free Actors"), STAT_ActorPoolFreeActors, STATGROUP_Nexus);
+
+AActor* UNexusActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+{
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = nullptr;
+
+	FNexusActorPool* Pool = Pools.Find(ActorClass);
+	while (Pool && !Actor && 0 < Pool->FreeActors.Num())
+	{
+		// Actors can be destroyed while pooled, e.g. by a level transition.
+		Actor = Pool->FreeActors.Pop(false);
+		DEC_DWORD_STAT(STAT_ActorPoolFreeActors);
+
+		if (IsValid(Actor))
+		{
+			Actor->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+			Actor->SetOwner(Owner);
+			Actor->SetInstigator(Instigator);
+
+			INC_DWORD_STAT(STAT_ActorPoolReused);
+		}
+		else
+		{
+			Actor = nullptr;
+		}
+	}
+
+	if (!Actor)
+	{
+		Actor = SpawnPooledActor(ActorClass, SpawnTransform, Owner, Instigator);
+	}
+
+	INexusPoolableActor* PoolableActor = Cast<INexusPoolableActor>(Actor);
+	if (PoolableActor)
+	{
+		PoolableActor->OnAcquiredFromPool();
+	}
+
+	return Actor;
+}
+
+void UNexusActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	INexusPoolableActor* PoolableActor = Cast<INexusPoolableActor>(Actor);
+	if (!PoolableActor)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	FNexusActorPool& Pool = Pools.FindOrAdd(Actor->GetClass());
+
+	// Already released.
+	if (Pool.FreeActors.Contains(Actor))
+	{
+		return;
+	}
+
+	PoolableActor->OnReleasedToPool();
+
+	Pool.FreeActors.Add(Actor);
+	INC_DWORD_STAT(STAT_ActorPoolFreeActors);
+}
+
+void UNexusActorPoolSubsystem::WarmPool(TSubclassOf<AActor> ActorClass, int32 NumActors)
+{
+	if (!ActorClass || !ActorClass->ImplementsInterface(UNexusPoolableActor::StaticClass()))
+	{
+		return;
+	}
+
+	FNexusActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	Pool.FreeActors.Reserve(NumActors);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// Construction is deferred so the actors are deactivated before they begin play, rather than starting up active and being released.
+	SpawnParameters.bDeferConstruction = true;
+
+	for (int32 ActorIndex = Pool.FreeActors.Num(); ActorIndex < NumActors; ++ActorIndex)
+	{
+		AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+		if (Actor)
+		{
+			INC_DWORD_STAT(STAT_ActorPoolSpawned);
+
+			Cast<INexusPoolableActor>(Actor)->OnSpawnedIntoPool();
+			Actor->FinishSpawning(FTransform::Identity);
+
+			Pool.FreeActors.Add(Actor);
+			INC_DWORD_STAT(STAT_ActorPoolFreeActors);
+		}
+	}
+}
+
+AActor* UNexusActorPoolSubsystem::SpawnPooledActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator) const
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.Instigator = Instigator;
+
+	INC_DWORD_STAT(STAT_ActorPoolSpawned);
+
+	return GetWorld()->SpawnActor<AActor>(ActorClass, SpawnTransform, SpawnParameters);
+}
@@ -0,0 +1,137 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusCharacterAimSubsystem.h"
+#include "NexusCharacter.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character Aim Update"), STAT_CharacterAimUpdate, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Character Aim Characters"), STAT_CharacterAimCharacters, STATGROUP_Nexus);
+
+bool UNexusCharacterAimSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNexusCharacterAimSubsystem::Deinitialize()
+{
+	Characters.Empty();
+	TargetPitchAngles.Empty();
+	TargetYawAngles.Empty();
+	PitchAngles.Empty();
+	YawAngles.Empty();
+
+	SET_DWORD_STAT(STAT_CharacterAimCharacters, 0);
+
+	Super::Deinitialize();
+}
+
+void UNexusCharacterAimSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterAimUpdate);
+
+	GatherTargetAngles();
+
+	InterpolateAngles(DeltaTime);
+
+	ApplySmoothedAngles();
+}
+
+bool UNexusCharacterAimSubsystem::IsTickable() const
+{
+	return 0 < Characters.Num();
+}
+
+TStatId UNexusCharacterAimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNexusCharacterAimSubsystem, STATGROUP_Tickables);
+}
+
+void UNexusCharacterAimSubsystem::RegisterCharacter(ANexusCharacter* Character)
+{
+	if (!Character || Characters.Contains(Character))
+	{
+		return;
+	}
+
+	float TargetPitch = 0.0f;
+	float TargetYaw = 0.0f;
+	Character->GetTargetAimAngles(TargetPitch, TargetYaw);
+
+	// Characters start at their target, rather than swinging up from zero.
+	Characters.Add(Character);
+	TargetPitchAngles.Add(TargetPitch);
+	TargetYawAngles.Add(TargetYaw);
+	PitchAngles.Add(TargetPitch);
+	YawAngles.Add(TargetYaw);
+
+	INC_DWORD_STAT(STAT_CharacterAimCharacters);
+}
+
+void UNexusCharacterAimSubsystem::UnregisterCharacter(ANexusCharacter* Character)
+{
+	const int32 CharacterIndex = Characters.IndexOfByKey(Character);
+	if (INDEX_NONE != CharacterIndex)
+	{
+		RemoveCharacterAt(CharacterIndex);
+	}
+}
+
+void UNexusCharacterAimSubsystem::GatherTargetAngles()
+{
+	// Iterate backwards, as characters destroyed without ending play are removed.
+	for (int32 CharacterIndex = Characters.Num() - 1; 0 <= CharacterIndex; --CharacterIndex)
+	{
+		const ANexusCharacter* Character = Characters[CharacterIndex].Get();
+		if (!Character)
+		{
+			RemoveCharacterAt(CharacterIndex);
+			continue;
+		}
+
+		Character->GetTargetAimAngles(TargetPitchAngles[CharacterIndex], TargetYawAngles[CharacterIndex]);
+	}
+}
+
+void UNexusCharacterAimSubsystem::InterpolateAngles(float DeltaTime)
+{
+	const float Alpha = FMath::Clamp(DeltaTime * AimInterpolationSpeed, 0.0f, 1.0f);
+	const int32 NumAngles = PitchAngles.Num();
+
+	float* RESTRICT Pitches = PitchAngles.GetData();
+	float* RESTRICT Yaws = YawAngles.GetData();
+	const float* RESTRICT TargetPitches = TargetPitchAngles.GetData();
+	const float* RESTRICT TargetYaws = TargetYawAngles.GetData();
+
+	// Matches FMath::RInterpTo for a rotator with no roll, one axis at a time.
+	for (int32 AngleIndex = 0; AngleIndex < NumAngles; ++AngleIndex)
+	{
+		const float PitchDelta = FRotator::NormalizeAxis(TargetPitches[AngleIndex] - Pitches[AngleIndex]);
+		Pitches[AngleIndex] = FMath::ClampAngle(Pitches[AngleIndex] + PitchDelta * Alpha, -90.0f, 90.0f);
+	}
+
+	for (int32 AngleIndex = 0; AngleIndex < NumAngles; ++AngleIndex)
+	{
+		const float YawDelta = FRotator::NormalizeAxis(TargetYaws[AngleIndex] - Yaws[AngleIndex]);
+		Yaws[AngleIndex] = FMath::ClampAngle(Yaws[AngleIndex] + YawDelta * Alpha, -90.0f, 90.0f);
+	}
+}
+
+void UNexusCharacterAimSubsystem::ApplySmoothedAngles() const
+{
+	for (int32 CharacterIndex = 0; CharacterIndex < Characters.Num(); ++CharacterIndex)
+	{
+		Characters[CharacterIndex]->SetSmoothedAimAngles(PitchAngles[CharacterIndex], YawAngles[CharacterIndex]);
+	}
+}
+
+void UNexusCharacterAimSubsystem::RemoveCharacterAt(int32 CharacterIndex)
+{
+	Characters.RemoveAtSwap(CharacterIndex, 1, false);
+	TargetPitchAngles.RemoveAtSwap(CharacterIndex, 1, false);
+	TargetYawAngles.RemoveAtSwap(CharacterIndex, 1, false);
+	PitchAngles.RemoveAtSwap(CharacterIndex, 1, false);
+	YawAngles.RemoveAtSwap(CharacterIndex, 1, false);
+
+	DEC_DWORD_STAT(STAT_CharacterAimCharacters);
+}
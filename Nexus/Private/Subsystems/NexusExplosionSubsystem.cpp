@@ -0,0 +1,275 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusExplosionSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/EngineTypes.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Components/PrimitiveComponent.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Apply Explosion"), STAT_ApplyExplosion, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions Applied"), STAT_ExplosionsApplied, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions Deferred"), STAT_ExplosionsDeferred, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Occlusion Traces"), STAT_ExplosionOcclusionTraces, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Explosions"), STAT_QueuedExplosions, STATGROUP_Nexus);
+
+void UNexusExplosionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	OcclusionTraceDelegate.BindUObject(this, &UNexusExplosionSubsystem::OnOcclusionTraceCompleted);
+}
+
+void UNexusExplosionSubsystem::Deinitialize()
+{
+	OcclusionTraceDelegate.Unbind();
+
+	QueuedExplosions.Empty();
+	PendingExplosionDamage.Empty();
+
+	Super::Deinitialize();
+}
+
+void UNexusExplosionSubsystem::Tick(float DeltaTime)
+{
+	// Drain the queue oldest first, until the frame budget has been used. The rest wait for the next frame.
+	int32 NumApplied = 0;
+	while (NumApplied < QueuedExplosions.Num() && HasFrameBudget())
+	{
+		// Explosions queued while this one is applied are appended, so the index stays valid.
+		const FNexusExplosion Explosion = QueuedExplosions[NumApplied++];
+		ApplyExplosion(Explosion);
+	}
+
+	QueuedExplosions.RemoveAt(0, NumApplied, false);
+
+	SET_DWORD_STAT(STAT_QueuedExplosions, QueuedExplosions.Num());
+}
+
+bool UNexusExplosionSubsystem::IsTickable() const
+{
+	// Nothing to do while no chain reactions are waiting.
+	return 0 < QueuedExplosions.Num();
+}
+
+TStatId UNexusExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNexusExplosionSubsystem, STATGROUP_Tickables);
+}
+
+void UNexusExplosionSubsystem::QueueExplosion(const FNexusExplosion& Explosion)
+{
+	// Explosions set off by another explosion's damage are deferred, so a chain reaction is spread over several frames instead of recursing.
+	if (bApplyingExplosion || 0 < QueuedExplosions.Num() || !HasFrameBudget())
+	{
+		QueuedExplosions.Add(Explosion);
+
+		INC_DWORD_STAT(STAT_ExplosionsDeferred);
+		SET_DWORD_STAT(STAT_QueuedExplosions, QueuedExplosions.Num());
+		return;
+	}
+
+	ApplyExplosion(Explosion);
+}
+
+void UNexusExplosionSubsystem::ApplyExplosion(const FNexusExplosion& Explosion)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ApplyExplosion);
+	INC_DWORD_STAT(STAT_ExplosionsApplied);
+
+	TGuardValue<bool> ApplyingExplosionGuard(bApplyingExplosion, true);
+
+	UWorld* World = GetWorld();
+	AActor* DamageCauser = Explosion.DamageCauser.Get();
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NexusExplosion), false, DamageCauser);
+
+	// One overlap is shared by damage and impulse.
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByObjectType(Overlaps, Explosion.Origin, FQuat::Identity, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllDynamicObjects), FCollisionShape::MakeSphere(Explosion.Radius), QueryParams);
+
+	// Group the overlapped components by actor, so each actor is damaged once.
+	TMap<AActor*, TArray<UPrimitiveComponent*, TInlineAllocator<4>>> OverlapComponentMap;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* OverlapActor = Overlap.GetActor();
+		UPrimitiveComponent* OverlapComponent = Overlap.Component.Get();
+
+		if (OverlapActor && OverlapComponent && OverlapActor != DamageCauser)
+		{
+			OverlapComponentMap.FindOrAdd(OverlapActor).Add(OverlapComponent);
+		}
+	}
+
+	FPendingExplosionDamage PendingDamage;
+	PendingDamage.Explosion = Explosion;
+	PendingDamage.ExplosionId = NextExplosionId++;
+
+	FCollisionQueryParams LineParams(SCENE_QUERY_STAT(NexusExplosionOcclusion), true, DamageCauser);
+
+	for (const TPair<AActor*, TArray<UPrimitiveComponent*, TInlineAllocator<4>>>& OverlapComponents : OverlapComponentMap)
+	{
+		AActor* const OverlapActor = OverlapComponents.Key;
+
+		if (!IsValid(OverlapActor))
+		{
+			continue;
+		}
+
+		if (0.0f < Explosion.ImpulseStrength)
+		{
+			for (UPrimitiveComponent* OverlapComponent : OverlapComponents.Value)
+			{
+				if (IsValid(OverlapComponent) && OverlapComponent->IsSimulatingPhysics())
+				{
+					OverlapComponent->AddRadialImpulse(Explosion.Origin, Explosion.Radius, Explosion.ImpulseStrength, RIF_Constant, Explosion.bImpulseVelChange);
+				}
+			}
+
+			UMovementComponent* MovementComponent = OverlapActor->FindComponentByClass<UMovementComponent>();
+			if (MovementComponent)
+			{
+				MovementComponent->AddRadialImpulse(Explosion.Origin, Explosion.Radius, Explosion.ImpulseStrength, RIF_Constant, Explosion.bImpulseVelChange);
+			}
+		}
+
+		// Actors that cannot be damaged are still pushed by the impulse.
+		if (0.0f >= Explosion.BaseDamage || !OverlapActor->CanBeDamaged())
+		{
+			continue;
+		}
+
+		// Every component is traced, so the damage event receives every component the explosion reached.
+		for (UPrimitiveComponent* OverlapComponent : OverlapComponents.Value)
+		{
+			FExplosionOcclusionTrace& OcclusionTrace = PendingDamage.OcclusionTraces.AddDefaulted_GetRef();
+			OcclusionTrace.Actor = OverlapActor;
+			OcclusionTrace.Component = OverlapComponent;
+			OcclusionTrace.TraceEnd = OverlapComponent->Bounds.Origin;
+
+			// The results are gathered with the rest of the frame's async traces, and delivered at the start of the next frame.
+			OcclusionTrace.TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Explosion.Origin, OcclusionTrace.TraceEnd, DamagePreventionChannel, LineParams,
+				FCollisionResponseParams::DefaultResponseParam, &OcclusionTraceDelegate, PendingDamage.ExplosionId);
+		}
+	}
+
+	PendingDamage.TracesRemaining = PendingDamage.OcclusionTraces.Num();
+	INC_DWORD_STAT_BY(STAT_ExplosionOcclusionTraces, PendingDamage.TracesRemaining);
+
+	if (0 == PendingDamage.TracesRemaining)
+	{
+		// Nothing to damage.
+		Explosion.OnApplied.ExecuteIfBound();
+		return;
+	}
+
+	PendingExplosionDamage.Add(MoveTemp(PendingDamage));
+}
+
+void UNexusExplosionSubsystem::OnOcclusionTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 PendingDamageIndex = PendingExplosionDamage.IndexOfByPredicate([&TraceDatum](const FPendingExplosionDamage& PendingDamage)
+	{
+		return PendingDamage.ExplosionId == TraceDatum.UserData;
+	});
+
+	if (INDEX_NONE == PendingDamageIndex)
+	{
+		return;
+	}
+
+	FPendingExplosionDamage& PendingDamage = PendingExplosionDamage[PendingDamageIndex];
+
+	FExplosionOcclusionTrace* OcclusionTrace = PendingDamage.OcclusionTraces.FindByPredicate([&TraceHandle](const FExplosionOcclusionTrace& Trace)
+	{
+		return Trace.TraceHandle == TraceHandle;
+	});
+
+	UPrimitiveComponent* Component = OcclusionTrace ? OcclusionTrace->Component.Get() : nullptr;
+	if (Component)
+	{
+		const FHitResult* Hit = 0 < TraceDatum.OutHits.Num() && TraceDatum.OutHits[0].bBlockingHit ? &TraceDatum.OutHits[0] : nullptr;
+
+		// Blocked by something other than the component being damaged.
+		OcclusionTrace->bExposed = !Hit || Hit->Component == Component;
+
+		if (OcclusionTrace->bExposed)
+		{
+			const FVector FakeHitNormal = (PendingDamage.Explosion.Origin - OcclusionTrace->TraceEnd).GetSafeNormal();
+
+			OcclusionTrace->ExposedHit = Hit ? *Hit : FHitResult(Component->GetOwner(), Component, OcclusionTrace->TraceEnd, FakeHitNormal);
+			OcclusionTrace->ExposedHit.ImpactNormal = FakeHitNormal;
+		}
+	}
+
+	if (0 < --PendingDamage.TracesRemaining)
+	{
+		return;
+	}
+
+	// Removed before the damage is applied, as the damage can set off other explosions.
+	const FPendingExplosionDamage CompletedDamage = MoveTemp(PendingDamage);
+	PendingExplosionDamage.RemoveAtSwap(PendingDamageIndex, 1, false);
+
+	ApplyExplosionDamage(CompletedDamage);
+}
+
+void UNexusExplosionSubsystem::ApplyExplosionDamage(const FPendingExplosionDamage& PendingDamage)
+{
+	TGuardValue<bool> ApplyingExplosionGuard(bApplyingExplosion, true);
+
+	const FNexusExplosion& Explosion = PendingDamage.Explosion;
+
+	FRadialDamageEvent DamageEvent;
+	DamageEvent.DamageTypeClass = Explosion.DamageType ? Explosion.DamageType : TSubclassOf<UDamageType>(UDamageType::StaticClass());
+	DamageEvent.Origin = Explosion.Origin;
+	DamageEvent.Params = FRadialDamageParams(Explosion.BaseDamage, 0.0f, Explosion.Radius, Explosion.Radius, 1.0f);
+
+	const TArray<FExplosionOcclusionTrace>& OcclusionTraces = PendingDamage.OcclusionTraces;
+
+	// The traces are grouped by actor, so each actor is damaged once with all of its exposed components.
+	int32 TraceIndex = 0;
+	while (TraceIndex < OcclusionTraces.Num())
+	{
+		const TWeakObjectPtr<AActor> DamagedActor = OcclusionTraces[TraceIndex].Actor;
+
+		DamageEvent.ComponentHits.Reset();
+		for (; TraceIndex < OcclusionTraces.Num() && OcclusionTraces[TraceIndex].Actor == DamagedActor; ++TraceIndex)
+		{
+			if (OcclusionTraces[TraceIndex].bExposed)
+			{
+				DamageEvent.ComponentHits.Add(OcclusionTraces[TraceIndex].ExposedHit);
+			}
+		}
+
+		// Actors can be destroyed while the traces are in flight, or by damage applied earlier in this loop.
+		AActor* OverlapActor = DamagedActor.Get();
+		if (IsValid(OverlapActor) && 0 < DamageEvent.ComponentHits.Num())
+		{
+			OverlapActor->TakeDamage(Explosion.BaseDamage, DamageEvent, Explosion.InstigatedBy.Get(), Explosion.DamageCauser.Get());
+		}
+	}
+
+	Explosion.OnApplied.ExecuteIfBound();
+}
+
+bool UNexusExplosionSubsystem::HasFrameBudget()
+{
+	if (BudgetFrameNumber != GFrameCounter)
+	{
+		BudgetFrameNumber = GFrameCounter;
+		NumExplosionsThisFrame = 0;
+	}
+
+	if (NumExplosionsThisFrame >= MaxExplosionsPerFrame)
+	{
+		return false;
+	}
+
+	++NumExplosionsThisFrame;
+	return true;
+}
@@ -0,0 +1,179 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusFootstepAudioSubsystem.h"
+#include "NexusCharacter.h"
+#include "Components/AudioComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "Nexus/Utils/NexusTypeDefinitions.h"
+#include "Nexus/Utils/Logging/NexusLogging.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Played"), STAT_FootstepsPlayed, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Culled (Distance)"), STAT_FootstepsCulledDistance, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Culled (Budget)"), STAT_FootstepsCulledBudget, STATGROUP_Nexus);
+
+bool UNexusFootstepAudioSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNexusFootstepAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SurfaceVoices.SetNum(static_cast<int32>(EFootstepSurface::Num));
+	SurfaceVoices[static_cast<int32>(EFootstepSurface::Grass)].MaxVoices = MaxGrassVoices;
+	SurfaceVoices[static_cast<int32>(EFootstepSurface::Crouch)].MaxVoices = MaxCrouchVoices;
+	SurfaceVoices[static_cast<int32>(EFootstepSurface::Default)].MaxVoices = MaxDefaultVoices;
+
+	for (FFootstepVoices& Voices : SurfaceVoices)
+	{
+		Voices.AudioComponents.Reserve(Voices.MaxVoices);
+	}
+}
+
+void UNexusFootstepAudioSubsystem::Deinitialize()
+{
+	// Report how many footsteps were culled, so the budgets can be tuned.
+	if (0 < NumFootstepsPlayed + NumFootstepsCulled)
+	{
+		FStringFormatOrderedArguments LogArgs;
+		LogArgs.Add(FStringFormatArg(NumFootstepsPlayed));
+		LogArgs.Add(FStringFormatArg(NumFootstepsCulled));
+
+		FNexusLogging::Log(ELogLevel::INFO, FString::Format(TEXT("Footsteps: {0} played, {1} culled."), LogArgs), ELogOutput::OUTPUT_LOG);
+	}
+
+	SurfaceVoices.Empty();
+
+	Super::Deinitialize();
+}
+
+void UNexusFootstepAudioSubsystem::PlayFootstep(ANexusCharacter* Character, USkeletalMeshComponent* MeshComponent)
+{
+	if (!Character || !MeshComponent)
+	{
+		return;
+	}
+
+	// Footsteps should not be played when in the air.
+	if (!Character->GetCharacterMovement()->CurrentFloor.bBlockingHit)
+	{
+		return;
+	}
+
+	const EFootstepSurface Surface = GetFootstepSurface(Character);
+
+	USoundBase* FootstepSound = GetFootstepSound(Character, Surface);
+	if (!FootstepSound)
+	{
+		return;
+	}
+
+	if (!IsAudible(MeshComponent->GetComponentLocation(), FootstepSound))
+	{
+		++NumFootstepsCulled;
+		INC_DWORD_STAT(STAT_FootstepsCulledDistance);
+		return;
+	}
+
+	if (BudgetFrameNumber != GFrameCounter)
+	{
+		BudgetFrameNumber = GFrameCounter;
+		FootstepsThisFrame = 0;
+	}
+
+	FFootstepVoices& Voices = SurfaceVoices[static_cast<int32>(Surface)];
+
+	// Finished voices are removed for every footstep, including the local player's, so the list does not grow while the budget is not checked.
+	const int32 NumVoicesPlaying = UpdateVoices(Voices);
+
+	// The local player always hears their own footsteps, so they are never culled by the budgets.
+	const bool bLocalPlayer = Character->IsLocallyControlled() && Character->IsPlayerControlled();
+
+	// Footsteps are short and frequent, so a footstep over budget is dropped rather than stopping one already playing.
+	if (!bLocalPlayer && (FootstepsThisFrame >= MaxFootstepsPerFrame || NumVoicesPlaying >= Voices.MaxVoices))
+	{
+		++NumFootstepsCulled;
+		INC_DWORD_STAT(STAT_FootstepsCulledBudget);
+		return;
+	}
+
+	UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(FootstepSound, MeshComponent);
+	if (AudioComponent)
+	{
+		Voices.AudioComponents.Add(AudioComponent);
+	}
+
+	++FootstepsThisFrame;
+
+	++NumFootstepsPlayed;
+	INC_DWORD_STAT(STAT_FootstepsPlayed);
+}
+
+EFootstepSurface UNexusFootstepAudioSubsystem::GetFootstepSurface(const ANexusCharacter* Character)
+{
+	const UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement();
+
+	// Check if the current "floor" is grass.
+	if (SURFACE_ENVIRONMENT_GRASS == UPhysicalMaterial::DetermineSurfaceType(CharacterMovement->CurrentFloor.HitResult.PhysMaterial.Get()))
+	{
+		return EFootstepSurface::Grass;
+	}
+
+	return CharacterMovement->IsCrouching() ? EFootstepSurface::Crouch : EFootstepSurface::Default;
+}
+
+USoundBase* UNexusFootstepAudioSubsystem::GetFootstepSound(const ANexusCharacter* Character, EFootstepSurface Surface)
+{
+	// Indexed by EFootstepSurface.
+	USoundBase* const FootstepSounds[] = { Character->GrassFootstepSFX, Character->CrouchFootstepSFX, Character->FootstepSFX };
+	static_assert(UE_ARRAY_COUNT(FootstepSounds) == static_cast<int32>(EFootstepSurface::Num), "Every footstep surface needs a sound.");
+
+	return FootstepSounds[static_cast<int32>(Surface)];
+}
+
+bool UNexusFootstepAudioSubsystem::IsAudible(const FVector& Location, const USoundBase* Sound) const
+{
+	const float AudibleDistance = FMath::Min(MaxAudibleDistance, Sound->GetMaxDistance());
+
+	for (FConstPlayerControllerIterator PlayerIterator = GetWorld()->GetPlayerControllerIterator(); PlayerIterator; ++PlayerIterator)
+	{
+		const APlayerController* PlayerController = PlayerIterator->Get();
+		if (!PlayerController || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ListenerLocation;
+		FVector ListenerFrontDirection;
+		FVector ListenerRightDirection;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, ListenerFrontDirection, ListenerRightDirection);
+
+		if (FVector::DistSquared(Location, ListenerLocation) <= FMath::Square(AudibleDistance))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 UNexusFootstepAudioSubsystem::UpdateVoices(FFootstepVoices& Voices)
+{
+	for (int32 VoiceIndex = Voices.AudioComponents.Num() - 1; 0 <= VoiceIndex; --VoiceIndex)
+	{
+		const UAudioComponent* AudioComponent = Voices.AudioComponents[VoiceIndex].Get();
+		if (!AudioComponent || !AudioComponent->IsPlaying())
+		{
+			Voices.AudioComponents.RemoveAtSwap(VoiceIndex, 1, false);
+		}
+	}
+
+	return Voices.AudioComponents.Num();
+}
@@ -0,0 +1,207 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusImpactEffectSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Nexus/Utils/NexusTypeDefinitions.h"
+#include "Nexus/Utils/Logging/NexusLogging.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effect Pool Hits"), STAT_ImpactEffectPoolHits, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effect Pool Misses"), STAT_ImpactEffectPoolMisses, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effects Recycled"), STAT_ImpactEffectsRecycled, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Effects Culled"), STAT_ImpactEffectsCulled, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Impact Effect Pooled Components"), STAT_ImpactEffectPooledComponents, STATGROUP_Nexus);
+
+bool UNexusImpactEffectSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNexusImpactEffectSubsystem::Deinitialize()
+{
+	static const TCHAR* SurfaceGroupNames[] = { TEXT("Head"), TEXT("Body"), TEXT("Limbs"), TEXT("Default") };
+
+	for (int32 PoolIndex = 0; PoolIndex < Pools.Num(); ++PoolIndex)
+	{
+		FImpactEffectPool& Pool = Pools[PoolIndex];
+
+		// Report how well each pool was sized, so the budgets can be tuned.
+		if (0 < Pool.PoolHits + Pool.PoolMisses)
+		{
+			FStringFormatOrderedArguments LogArgs;
+			LogArgs.Add(FStringFormatArg(SurfaceGroupNames[PoolIndex]));
+			LogArgs.Add(FStringFormatArg(Pool.PoolHits));
+			LogArgs.Add(FStringFormatArg(Pool.PoolMisses));
+			LogArgs.Add(FStringFormatArg(Pool.Components.Num()));
+
+			FNexusLogging::Log(ELogLevel::INFO, FString::Format(TEXT("{0} impact effect pool: {1} hits, {2} misses, {3} components."), LogArgs), ELogOutput::OUTPUT_LOG);
+		}
+
+		DEC_DWORD_STAT_BY(STAT_ImpactEffectPooledComponents, Pool.Components.Num());
+
+		for (UParticleSystemComponent* PooledComponent : Pool.Components)
+		{
+			if (PooledComponent)
+			{
+				PooledComponent->DestroyComponent();
+			}
+		}
+	}
+
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UNexusImpactEffectSubsystem::WarmPools()
+{
+	if (0 < Pools.Num())
+	{
+		return;
+	}
+
+	Pools.SetNum(static_cast<int32>(EImpactSurfaceGroup::Num));
+	Pools[static_cast<int32>(EImpactSurfaceGroup::Head)].MaxPoolSize = HeadPoolSize;
+	Pools[static_cast<int32>(EImpactSurfaceGroup::Body)].MaxPoolSize = BodyPoolSize;
+	Pools[static_cast<int32>(EImpactSurfaceGroup::Limbs)].MaxPoolSize = LimbsPoolSize;
+	Pools[static_cast<int32>(EImpactSurfaceGroup::Default)].MaxPoolSize = DefaultPoolSize;
+
+	for (FImpactEffectPool& Pool : Pools)
+	{
+		Pool.Components.Reserve(Pool.MaxPoolSize);
+		Pool.ActivationOrder.Reserve(Pool.MaxPoolSize);
+
+		const int32 NumToWarm = FMath::Min(WarmPoolSize, Pool.MaxPoolSize);
+		for (int32 ComponentIndex = 0; ComponentIndex < NumToWarm; ++ComponentIndex)
+		{
+			AddPooledComponent(Pool);
+		}
+	}
+}
+
+void UNexusImpactEffectSubsystem::PlayImpactEffect(UParticleSystem* ImpactVFX, EPhysicalSurface SurfaceType, const FVector& Location, const FRotator& Rotation)
+{
+	if (!ImpactVFX)
+	{
+		return;
+	}
+
+	WarmPools();
+
+	FImpactEffectPool& Pool = Pools[static_cast<int32>(GetSurfaceGroup(SurfaceType))];
+
+	int32 IdleIndex = INDEX_NONE;
+	int32 OldestActiveIndex = INDEX_NONE;
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Pool.Components.Num(); ++ComponentIndex)
+	{
+		const UParticleSystemComponent* PooledComponent = Pool.Components[ComponentIndex];
+
+		if (PooledComponent->IsActive())
+		{
+			if (INDEX_NONE == OldestActiveIndex || Pool.ActivationOrder[ComponentIndex] < Pool.ActivationOrder[OldestActiveIndex])
+			{
+				OldestActiveIndex = ComponentIndex;
+			}
+		}
+		else if (INDEX_NONE == IdleIndex || PooledComponent->Template == ImpactVFX)
+		{
+			// Prefer an idle component that already uses the effect, so its emitter instances can be reused.
+			IdleIndex = ComponentIndex;
+		}
+	}
+
+	const bool bUnderActiveLimit = CountActiveImpactEffects() < MaxActiveImpactEffects;
+
+	int32 ComponentIndex = INDEX_NONE;
+
+	if (bUnderActiveLimit && INDEX_NONE != IdleIndex)
+	{
+		ComponentIndex = IdleIndex;
+
+		++Pool.PoolHits;
+		INC_DWORD_STAT(STAT_ImpactEffectPoolHits);
+	}
+	else if (bUnderActiveLimit && Pool.Components.Num() < Pool.MaxPoolSize)
+	{
+		ComponentIndex = AddPooledComponent(Pool);
+
+		++Pool.PoolMisses;
+		INC_DWORD_STAT(STAT_ImpactEffectPoolMisses);
+	}
+	else if (INDEX_NONE != OldestActiveIndex)
+	{
+		// Budget is used up, so the oldest effect in the pool is cut short and reused.
+		ComponentIndex = OldestActiveIndex;
+
+		++Pool.PoolMisses;
+		INC_DWORD_STAT(STAT_ImpactEffectPoolMisses);
+		INC_DWORD_STAT(STAT_ImpactEffectsRecycled);
+	}
+	else
+	{
+		// The active limit has been reached by other pools, and this pool has nothing to recycle.
+		INC_DWORD_STAT(STAT_ImpactEffectsCulled);
+		return;
+	}
+
+	UParticleSystemComponent* PooledComponent = Pool.Components[ComponentIndex];
+
+	if (PooledComponent->Template != ImpactVFX)
+	{
+		PooledComponent->SetTemplate(ImpactVFX);
+	}
+
+	PooledComponent->SetWorldLocationAndRotation(Location, Rotation);
+	PooledComponent->Activate(true);
+
+	Pool.ActivationOrder[ComponentIndex] = NextActivationOrder++;
+}
+
+EImpactSurfaceGroup UNexusImpactEffectSubsystem::GetSurfaceGroup(EPhysicalSurface SurfaceType)
+{
+	switch (SurfaceType)
+	{
+		case SURFACE_CHARACTER_HEAD:
+			return EImpactSurfaceGroup::Head;
+		case SURFACE_CHARACTER_BODY:
+			return EImpactSurfaceGroup::Body;
+		case SURFACE_CHARACTER_LIMBS:
+			return EImpactSurfaceGroup::Limbs;
+		default:
+			return EImpactSurfaceGroup::Default;
+	}
+}
+
+int32 UNexusImpactEffectSubsystem::AddPooledComponent(FImpactEffectPool& Pool)
+{
+	UParticleSystemComponent* PooledComponent = NewObject<UParticleSystemComponent>(GetWorld());
+	// Pooled components are activated and deactivated manually, and must outlive the effects they play.
+	PooledComponent->bAutoActivate = false;
+	PooledComponent->bAutoDestroy = false;
+	PooledComponent->SetAbsolute(true, true, true);
+	PooledComponent->RegisterComponentWithWorld(GetWorld());
+
+	Pool.ActivationOrder.Add(0);
+
+	INC_DWORD_STAT(STAT_ImpactEffectPooledComponents);
+
+	return Pool.Components.Add(PooledComponent);
+}
+
+int32 UNexusImpactEffectSubsystem::CountActiveImpactEffects() const
+{
+	int32 NumActiveEffects = 0;
+
+	for (const FImpactEffectPool& Pool : Pools)
+	{
+		for (const UParticleSystemComponent* PooledComponent : Pool.Components)
+		{
+			NumActiveEffects += PooledComponent->IsActive() ? 1 : 0;
+		}
+	}
+
+	return NumActiveEffects;
+}
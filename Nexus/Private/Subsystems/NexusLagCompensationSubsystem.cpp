@@ -0,0 +1,79 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusLagCompensationSubsystem.h"
+#include "Components/NexusHitboxHistoryComponent.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Rewind"), STAT_LagCompensationRewind, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensation Rewound Hitbox Histories"), STAT_LagCompensationRewoundHistories, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lag Compensation Hitbox Histories"), STAT_LagCompensationHistories, STATGROUP_Nexus);
+
+void UNexusLagCompensationSubsystem::RegisterHitboxHistory(UNexusHitboxHistoryComponent* HitboxHistory)
+{
+	if (HitboxHistory)
+	{
+		HitboxHistories.AddUnique(HitboxHistory);
+
+		// Reserve space up front, so rewinding never allocates.
+		RewoundHitboxHistories.Reserve(HitboxHistories.Num());
+
+		SET_DWORD_STAT(STAT_LagCompensationHistories, HitboxHistories.Num());
+	}
+}
+
+void UNexusLagCompensationSubsystem::UnregisterHitboxHistory(UNexusHitboxHistoryComponent* HitboxHistory)
+{
+	HitboxHistories.RemoveSwap(HitboxHistory);
+	RewoundHitboxHistories.RemoveSwap(HitboxHistory);
+
+	SET_DWORD_STAT(STAT_LagCompensationHistories, HitboxHistories.Num());
+}
+
+void UNexusLagCompensationSubsystem::RewindHitboxes(float RewindTime, const AActor* IgnoredActor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind);
+
+	// Never rewind further than the allowed window, or into the future.
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const float ClampedRewindTime = FMath::Clamp(RewindTime, CurrentTime - MaxRewindTime, CurrentTime);
+
+	for (UNexusHitboxHistoryComponent* HitboxHistory : HitboxHistories)
+	{
+		if (HitboxHistory && HitboxHistory->GetOwner() != IgnoredActor && HitboxHistory->RewindHitboxes(ClampedRewindTime))
+		{
+			RewoundHitboxHistories.Add(HitboxHistory);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_LagCompensationRewoundHistories, RewoundHitboxHistories.Num());
+}
+
+void UNexusLagCompensationSubsystem::RestoreHitboxes()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind);
+
+	for (UNexusHitboxHistoryComponent* HitboxHistory : RewoundHitboxHistories)
+	{
+		HitboxHistory->RestoreHitboxes();
+	}
+
+	RewoundHitboxHistories.Reset();
+}
+
+FNexusScopedLagCompensation::FNexusScopedLagCompensation(UWorld* World, float RewindTime, const AActor* IgnoredActor)
+	: LagCompensationSubsystem(World ? World->GetSubsystem<UNexusLagCompensationSubsystem>() : nullptr)
+{
+	if (LagCompensationSubsystem)
+	{
+		LagCompensationSubsystem->RewindHitboxes(RewindTime, IgnoredActor);
+	}
+}
+
+FNexusScopedLagCompensation::~FNexusScopedLagCompensation()
+{
+	if (LagCompensationSubsystem)
+	{
+		LagCompensationSubsystem->RestoreHitboxes();
+	}
+}
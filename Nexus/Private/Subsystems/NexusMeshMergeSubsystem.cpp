@@ -0,0 +1,130 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusMeshMergeSubsystem.h"
+#include "Engine/SkeletalMesh.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "SkeletalMeshMerge.h"
+#include "Nexus/Utils/Logging/NexusLogging.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Mesh Merge"), STAT_MeshMerge, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Mesh Merge Cache Hits"), STAT_MeshMergeCacheHits, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Mesh Merge Cached Meshes"), STAT_MeshMergeCachedMeshes, STATGROUP_Nexus);
+
+bool UNexusMeshMergeSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNexusMeshMergeSubsystem::Deinitialize()
+{
+	MergedMeshes.Empty();
+
+	SET_DWORD_STAT(STAT_MeshMergeCachedMeshes, 0);
+
+	Super::Deinitialize();
+}
+
+USkeletalMesh* UNexusMeshMergeSubsystem::GetMergedMesh(const TArray<USkeletalMesh*>& Parts)
+{
+	if (0 == Parts.Num() || Parts.Contains(nullptr))
+	{
+		return nullptr;
+	}
+
+	const FString VariantKey = GetVariantKey(Parts);
+
+	USkeletalMesh** CachedMesh = MergedMeshes.Find(VariantKey);
+	if (CachedMesh)
+	{
+		INC_DWORD_STAT(STAT_MeshMergeCacheHits);
+		return *CachedMesh;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MeshMerge);
+
+	USkeletalMesh* BaseMesh = Parts[0];
+
+	USkeletalMesh* MergedMesh = NewObject<USkeletalMesh>(this, NAME_None, RF_Transient);
+	MergedMesh->Skeleton = BaseMesh->Skeleton;
+
+	// Use the base mesh's physics asset, so hit volumes and ragdolls are unchanged.
+	MergedMesh->PhysicsAsset = BaseMesh->PhysicsAsset;
+
+	// Every section of every part is kept as its own merged section, even where parts share a material, so each part's materials can be set by section.
+	TArray<FSkelMeshMergeSectionMapping> SectionMappings;
+	SectionMappings.SetNum(Parts.Num());
+
+	int32 NumMergedSections = 0;
+	for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+	{
+		const int32 NumPartSections = GetNumSections(Parts[PartIndex]);
+		for (int32 SectionIndex = 0; SectionIndex < NumPartSections; ++SectionIndex)
+		{
+			SectionMappings[PartIndex].SectionIDs.Add(NumMergedSections++);
+		}
+	}
+
+	FSkeletalMeshMerge MeshMerge(MergedMesh, Parts, SectionMappings, 0);
+
+	// Merging reads the parts' vertex data, so it needs CPU access enabled on the part meshes in cooked builds.
+	if (!MeshMerge.DoMerge())
+	{
+		FNexusLogging::Log(ELogLevel::ERROR, FString::Printf(TEXT("Could not merge character mesh %s."), *VariantKey));
+
+		// Cache the failure, so the merge is not retried for every character.
+		MergedMesh = nullptr;
+	}
+
+	MergedMeshes.Add(VariantKey, MergedMesh);
+	INC_DWORD_STAT(STAT_MeshMergeCachedMeshes);
+
+	return MergedMesh;
+}
+
+void UNexusMeshMergeSubsystem::GetPartMaterialIndices(USkeletalMesh* MergedMesh, const TArray<USkeletalMesh*>& Parts, int32 PartIndex, TArray<int32>& MaterialIndicesOut)
+{
+	MaterialIndicesOut.Reset();
+
+	const FSkeletalMeshRenderData* MergedRenderData = MergedMesh ? MergedMesh->GetResourceForRendering() : nullptr;
+	if (!MergedRenderData || 0 == MergedRenderData->LODRenderData.Num() || !Parts.IsValidIndex(PartIndex))
+	{
+		return;
+	}
+
+	// The part's sections follow the sections of the parts before it.
+	int32 FirstSectionIndex = 0;
+	for (int32 PreviousPartIndex = 0; PreviousPartIndex < PartIndex; ++PreviousPartIndex)
+	{
+		FirstSectionIndex += GetNumSections(Parts[PreviousPartIndex]);
+	}
+
+	const TArray<FSkelMeshRenderSection>& MergedSections = MergedRenderData->LODRenderData[0].RenderSections;
+	const int32 NumPartSections = GetNumSections(Parts[PartIndex]);
+
+	for (int32 SectionIndex = FirstSectionIndex; SectionIndex < FirstSectionIndex + NumPartSections && SectionIndex < MergedSections.Num(); ++SectionIndex)
+	{
+		MaterialIndicesOut.AddUnique(MergedSections[SectionIndex].MaterialIndex);
+	}
+}
+
+int32 UNexusMeshMergeSubsystem::GetNumSections(USkeletalMesh* Mesh)
+{
+	const FSkeletalMeshRenderData* RenderData = Mesh ? Mesh->GetResourceForRendering() : nullptr;
+
+	return RenderData && 0 < RenderData->LODRenderData.Num() ? RenderData->LODRenderData[0].RenderSections.Num() : 0;
+}
+
+FString UNexusMeshMergeSubsystem::GetVariantKey(const TArray<USkeletalMesh*>& Parts)
+{
+	FString VariantKey;
+
+	for (const USkeletalMesh* Part : Parts)
+	{
+		VariantKey += Part->GetPathName();
+		VariantKey += TEXT("+");
+	}
+
+	return VariantKey;
+}
@@ -0,0 +1,147 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusRagdollSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll Simulating Bodies"), STAT_RagdollSimulatingBodies, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ragdolls Frozen"), STAT_RagdollsFrozen, STATGROUP_Nexus);
+
+void UNexusRagdollSubsystem::Deinitialize()
+{
+	Ragdolls.Empty();
+	NumSimulatingBodies = 0;
+
+	SET_DWORD_STAT(STAT_RagdollSimulatingBodies, 0);
+
+	Super::Deinitialize();
+}
+
+void UNexusRagdollSubsystem::Tick(float DeltaTime)
+{
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+
+	// Iterate backwards, as frozen and destroyed ragdolls are removed.
+	for (int32 RagdollIndex = Ragdolls.Num() - 1; 0 <= RagdollIndex; --RagdollIndex)
+	{
+		FNexusRagdoll& Ragdoll = Ragdolls[RagdollIndex];
+
+		if (!Ragdoll.Mesh.IsValid() || ShouldFreezeRagdoll(Ragdoll, WorldTime))
+		{
+			FreezeRagdollAt(RagdollIndex);
+		}
+	}
+}
+
+bool UNexusRagdollSubsystem::IsTickable() const
+{
+	return 0 < Ragdolls.Num();
+}
+
+TStatId UNexusRagdollSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNexusRagdollSubsystem, STATGROUP_Tickables);
+}
+
+void UNexusRagdollSubsystem::RegisterRagdoll(USkeletalMeshComponent* Mesh)
+{
+	if (!Mesh || Ragdolls.ContainsByPredicate([Mesh](const FNexusRagdoll& Ragdoll) { return Ragdoll.Mesh.Get() == Mesh; }))
+	{
+		return;
+	}
+
+	FNexusRagdoll& Ragdoll = Ragdolls.AddDefaulted_GetRef();
+	Ragdoll.Mesh = Mesh;
+	Ragdoll.NumBodies = FMath::Max(Mesh->Bodies.Num(), 1);
+	Ragdoll.StartTime = GetWorld()->GetTimeSeconds();
+
+	NumSimulatingBodies += Ragdoll.NumBodies;
+	INC_DWORD_STAT_BY(STAT_RagdollSimulatingBodies, Ragdoll.NumBodies);
+
+	// Make room straight away, so a burst of kills does not overload the physics step for a frame.
+	EnforceBudget();
+}
+
+void UNexusRagdollSubsystem::UnregisterRagdoll(USkeletalMeshComponent* Mesh)
+{
+	const int32 RagdollIndex = Ragdolls.IndexOfByPredicate([Mesh](const FNexusRagdoll& Ragdoll) { return Ragdoll.Mesh.Get() == Mesh; });
+	if (INDEX_NONE == RagdollIndex)
+	{
+		return;
+	}
+
+	NumSimulatingBodies -= Ragdolls[RagdollIndex].NumBodies;
+	DEC_DWORD_STAT_BY(STAT_RagdollSimulatingBodies, Ragdolls[RagdollIndex].NumBodies);
+
+	Ragdolls.RemoveAt(RagdollIndex, 1, false);
+}
+
+int32 UNexusRagdollSubsystem::GetNumSimulatingBodies() const
+{
+	return NumSimulatingBodies;
+}
+
+bool UNexusRagdollSubsystem::ShouldFreezeRagdoll(FNexusRagdoll& Ragdoll, float WorldTime) const
+{
+	if (WorldTime - Ragdoll.StartTime >= MaxSimulationTime)
+	{
+		return true;
+	}
+
+	const USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+	// The physics engine has already put the ragdoll to sleep.
+	if (!Mesh->RigidBodyIsAwake())
+	{
+		return true;
+	}
+
+	if (FMath::Square(SettleSpeed) < Mesh->GetPhysicsLinearVelocity().SizeSquared())
+	{
+		Ragdoll.SettleStartTime = -1.0f;
+		return false;
+	}
+
+	if (0.0f > Ragdoll.SettleStartTime)
+	{
+		Ragdoll.SettleStartTime = WorldTime;
+	}
+
+	return WorldTime - Ragdoll.SettleStartTime >= SettleTime;
+}
+
+void UNexusRagdollSubsystem::EnforceBudget()
+{
+	// Freeze the oldest ragdolls first, as they have had the longest to fall.
+	while (NumSimulatingBodies > MaxSimulatingBodies && 0 < Ragdolls.Num())
+	{
+		FreezeRagdollAt(0);
+	}
+}
+
+void UNexusRagdollSubsystem::FreezeRagdollAt(int32 RagdollIndex)
+{
+	const FNexusRagdoll Ragdoll = Ragdolls[RagdollIndex];
+	Ragdolls.RemoveAt(RagdollIndex, 1, false);
+
+	NumSimulatingBodies -= Ragdoll.NumBodies;
+	DEC_DWORD_STAT_BY(STAT_RagdollSimulatingBodies, Ragdoll.NumBodies);
+
+	USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// Stop the mesh updating its bones, so it keeps the pose it is in.
+	Mesh->PutAllRigidBodiesToSleep();
+	Mesh->SetComponentTickEnabled(false);
+
+	// Kinematic bodies without collision are taken out of the physics step.
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	INC_DWORD_STAT(STAT_RagdollsFrozen);
+}
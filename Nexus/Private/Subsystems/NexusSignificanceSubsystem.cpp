@@ -0,0 +1,212 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusSignificanceSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_SignificanceUpdate, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance High"), STAT_SignificanceHigh, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Medium"), STAT_SignificanceMedium, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Low"), STAT_SignificanceLow, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Culled"), STAT_SignificanceCulled, STATGROUP_Nexus);
+
+void UNexusSignificanceSubsystem::Deinitialize()
+{
+	Entries.Empty();
+
+	SET_DWORD_STAT(STAT_SignificanceHigh, 0);
+	SET_DWORD_STAT(STAT_SignificanceMedium, 0);
+	SET_DWORD_STAT(STAT_SignificanceLow, 0);
+	SET_DWORD_STAT(STAT_SignificanceCulled, 0);
+
+	Super::Deinitialize();
+}
+
+void UNexusSignificanceSubsystem::Tick(float DeltaTime)
+{
+	TimeUntilUpdate -= DeltaTime;
+
+	if (0.0f < TimeUntilUpdate)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = UpdateInterval;
+
+	UpdateSignificance();
+}
+
+bool UNexusSignificanceSubsystem::IsTickable() const
+{
+	return 0 < Entries.Num();
+}
+
+TStatId UNexusSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNexusSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UNexusSignificanceSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!Actor || Entries.ContainsByPredicate([Actor](const FNexusSignificanceEntry& Entry) { return Entry.Actor.Get() == Actor; }))
+	{
+		return;
+	}
+
+	FNexusSignificanceEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Actor = Actor;
+	Entry.Tier = ENexusSignificanceTier::High;
+	Entry.DefaultTickInterval = Actor->GetActorTickInterval();
+
+	++NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::High)];
+}
+
+void UNexusSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	const int32 EntryIndex = Entries.IndexOfByPredicate([Actor](const FNexusSignificanceEntry& Entry) { return Entry.Actor.Get() == Actor; });
+
+	if (INDEX_NONE == EntryIndex)
+	{
+		return;
+	}
+
+	FNexusSignificanceEntry& Entry = Entries[EntryIndex];
+	--NumActorsPerTier[static_cast<int32>(Entry.Tier)];
+
+	// Unregistered actors are no longer managed, so go back to their full tick rate.
+	if (ENexusSignificanceTier::High != Entry.Tier)
+	{
+		ApplyTier(Entry, ENexusSignificanceTier::High);
+	}
+
+	Entries.RemoveAtSwap(EntryIndex, 1, false);
+}
+
+int32 UNexusSignificanceSubsystem::GetNumActorsInTier(ENexusSignificanceTier Tier) const
+{
+	return NumActorsPerTier[static_cast<int32>(Tier)];
+}
+
+void UNexusSignificanceSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SignificanceUpdate);
+
+	// View locations of every player. On the server this includes remote players, as their controllers exist there too.
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+
+		if (PlayerController && PlayerController->GetPawnOrSpectator())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	FMemory::Memzero(NumActorsPerTier);
+
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		FNexusSignificanceEntry& Entry = Entries[EntryIndex];
+		AActor* Actor = Entry.Actor.Get();
+
+		if (!Actor)
+		{
+			Entries.RemoveAtSwap(EntryIndex, 1, false);
+			continue;
+		}
+
+		const ENexusSignificanceTier NewTier = CalculateTier(Actor, ViewLocations);
+
+		if (NewTier != Entry.Tier)
+		{
+			ApplyTier(Entry, NewTier);
+		}
+
+		++NumActorsPerTier[static_cast<int32>(Entry.Tier)];
+	}
+
+	SET_DWORD_STAT(STAT_SignificanceHigh, NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::High)]);
+	SET_DWORD_STAT(STAT_SignificanceMedium, NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::Medium)]);
+	SET_DWORD_STAT(STAT_SignificanceLow, NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::Low)]);
+	SET_DWORD_STAT(STAT_SignificanceCulled, NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::Culled)]);
+}
+
+ENexusSignificanceTier UNexusSignificanceSubsystem::CalculateTier(const AActor* Actor, const TArray<FVector, TInlineAllocator<4>>& ViewLocations) const
+{
+	// Players always need their own pawn, and the server needs every player's pawn, at full rate.
+	const APawn* Pawn = Cast<APawn>(Actor);
+	if (Pawn && Pawn->IsPlayerControlled())
+	{
+		return ENexusSignificanceTier::High;
+	}
+
+	// Without a player there is nobody to see the actor, but gameplay must still run.
+	if (0 == ViewLocations.Num())
+	{
+		return ENexusSignificanceTier::High;
+	}
+
+	const FVector ActorLocation = Actor->GetActorLocation();
+
+	float ClosestDistanceSquared = MAX_flt;
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(ViewLocation, ActorLocation));
+	}
+
+	int32 Tier = ClosestDistanceSquared <= FMath::Square(HighSignificanceDistance) ? static_cast<int32>(ENexusSignificanceTier::High)
+		: ClosestDistanceSquared <= FMath::Square(MediumSignificanceDistance) ? static_cast<int32>(ENexusSignificanceTier::Medium)
+		: ClosestDistanceSquared <= FMath::Square(LowSignificanceDistance) ? static_cast<int32>(ENexusSignificanceTier::Low)
+		: static_cast<int32>(ENexusSignificanceTier::Culled);
+
+	// Actors nobody can currently see matter less. A dedicated server never renders, so only uses distance.
+	if (!IsRunningDedicatedServer() && !Actor->WasRecentlyRendered(RecentlyRenderedTime))
+	{
+		Tier = FMath::Min(Tier + 1, static_cast<int32>(ENexusSignificanceTier::Culled));
+	}
+
+	return static_cast<ENexusSignificanceTier>(Tier);
+}
+
+void UNexusSignificanceSubsystem::ApplyTier(FNexusSignificanceEntry& Entry, ENexusSignificanceTier Tier) const
+{
+	Entry.Tier = Tier;
+
+	AActor* Actor = Entry.Actor.Get();
+	if (!Actor)
+	{
+		return;
+	}
+
+	Actor->SetActorTickInterval(GetTierTickInterval(Entry, Tier));
+
+	INexusSignificanceInterface* SignificanceInterface = Cast<INexusSignificanceInterface>(Actor);
+	if (SignificanceInterface)
+	{
+		SignificanceInterface->OnSignificanceChanged(Tier);
+	}
+}
+
+float UNexusSignificanceSubsystem::GetTierTickInterval(const FNexusSignificanceEntry& Entry, ENexusSignificanceTier Tier) const
+{
+	switch (Tier)
+	{
+	case ENexusSignificanceTier::Medium:
+		return FMath::Max(MediumTickInterval, Entry.DefaultTickInterval);
+	case ENexusSignificanceTier::Low:
+		return FMath::Max(LowTickInterval, Entry.DefaultTickInterval);
+	case ENexusSignificanceTier::Culled:
+		return FMath::Max(CulledTickInterval, Entry.DefaultTickInterval);
+	default:
+		return Entry.DefaultTickInterval;
+	}
+}
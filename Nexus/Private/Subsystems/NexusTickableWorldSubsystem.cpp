@@ -0,0 +1,15 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+
+ETickableTickType UNexusTickableWorldSubsystem::GetTickableTickType() const
+{
+	// The class default object is registered as a tickable too, but must never tick.
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UNexusTickableWorldSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
@@ -0,0 +1,205 @@
+// Toyan Green © 2020
+
+
+#include "Subsystems/NexusTracerSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Nexus/Utils/NexusStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tracer Batch Update"), STAT_TracerBatchUpdate, STATGROUP_Nexus);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracers Added"), STAT_TracersAdded, STATGROUP_Nexus);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Tracers"), STAT_ActiveTracers, STATGROUP_Nexus);
+
+bool UNexusTracerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNexusTracerSubsystem::Deinitialize()
+{
+	if (TracerActor)
+	{
+		TracerActor->Destroy();
+		TracerActor = nullptr;
+	}
+
+	Batches.Empty();
+
+	SET_DWORD_STAT(STAT_ActiveTracers, 0);
+
+	Super::Deinitialize();
+}
+
+void UNexusTracerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TracerBatchUpdate);
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	NumActiveTracers = 0;
+
+	for (FTracerBatch& Batch : Batches)
+	{
+		if (0 < Batch.NumActiveSegments)
+		{
+			UpdateBatch(Batch, CurrentTime);
+
+			NumActiveTracers += Batch.NumActiveSegments;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ActiveTracers, NumActiveTracers);
+}
+
+bool UNexusTracerSubsystem::IsTickable() const
+{
+	// Nothing to update while there are no tracers in flight.
+	return 0 < NumActiveTracers;
+}
+
+TStatId UNexusTracerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNexusTracerSubsystem, STATGROUP_Tickables);
+}
+
+void UNexusTracerSubsystem::AddTracer(UStaticMesh* TracerMesh, UMaterialInterface* TracerMaterial, const FVector& Start, const FVector& Target)
+{
+	FTracerBatch* Batch = FindOrAddBatch(TracerMesh, TracerMaterial);
+
+	if (!Batch)
+	{
+		return;
+	}
+
+	FVector Direction;
+	float Length;
+	(Target - Start).ToDirectionAndLength(Direction, Length);
+
+	// Write over the oldest tracer. If it was still travelling, it is cut short.
+	FTracerSegment& Segment = Batch->Segments[Batch->NextSegmentIndex];
+
+	if (!Segment.bActive)
+	{
+		++Batch->NumActiveSegments;
+		++NumActiveTracers;
+	}
+
+	Segment.Start = Start;
+	Segment.Direction = Direction;
+	Segment.Length = Length;
+	Segment.StartTime = GetWorld()->GetTimeSeconds();
+	Segment.bActive = true;
+
+	Batch->NextSegmentIndex = (Batch->NextSegmentIndex + 1) % Batch->Segments.Num();
+
+	INC_DWORD_STAT(STAT_TracersAdded);
+}
+
+FTracerBatch* UNexusTracerSubsystem::FindOrAddBatch(UStaticMesh* TracerMesh, UMaterialInterface* TracerMaterial)
+{
+	if (!TracerMesh || 0 >= MaxTracersPerBatch)
+	{
+		return nullptr;
+	}
+
+	FTracerBatch* Batch = Batches.FindByPredicate([TracerMesh, TracerMaterial](const FTracerBatch& ExistingBatch)
+	{
+		return ExistingBatch.TracerMesh == TracerMesh && ExistingBatch.TracerMaterial == TracerMaterial;
+	});
+
+	if (Batch)
+	{
+		return Batch;
+	}
+
+	if (!TracerActor)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		TracerActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+
+		if (!TracerActor)
+		{
+			return nullptr;
+		}
+	}
+
+	UInstancedStaticMeshComponent* InstancedMeshComponent = NewObject<UInstancedStaticMeshComponent>(TracerActor);
+	InstancedMeshComponent->SetMobility(EComponentMobility::Movable);
+	InstancedMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	InstancedMeshComponent->SetCanEverAffectNavigation(false);
+	InstancedMeshComponent->SetCastShadow(false);
+	InstancedMeshComponent->SetStaticMesh(TracerMesh);
+
+	if (TracerMaterial)
+	{
+		InstancedMeshComponent->SetMaterial(0, TracerMaterial);
+	}
+
+	if (!TracerActor->GetRootComponent())
+	{
+		TracerActor->SetRootComponent(InstancedMeshComponent);
+	}
+
+	InstancedMeshComponent->RegisterComponent();
+
+	Batch = &Batches.AddDefaulted_GetRef();
+	Batch->TracerMesh = TracerMesh;
+	Batch->TracerMaterial = TracerMaterial;
+	Batch->InstancedMeshComponent = InstancedMeshComponent;
+	Batch->MeshLength = FMath::Max(TracerMesh->GetBounds().BoxExtent.X * 2.0f, KINDA_SMALL_NUMBER);
+
+	// Every segment has an instance for the lifetime of the batch. Inactive segments are hidden with a zero scale.
+	const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+
+	Batch->Segments.SetNumZeroed(MaxTracersPerBatch);
+	Batch->InstanceTransforms.Init(HiddenTransform, MaxTracersPerBatch);
+
+	for (int32 SegmentIndex = 0; SegmentIndex < MaxTracersPerBatch; ++SegmentIndex)
+	{
+		InstancedMeshComponent->AddInstanceWorldSpace(HiddenTransform);
+	}
+
+	return Batch;
+}
+
+void UNexusTracerSubsystem::UpdateBatch(FTracerBatch& Batch, float CurrentTime) const
+{
+	const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+
+	for (int32 SegmentIndex = 0; SegmentIndex < Batch.Segments.Num(); ++SegmentIndex)
+	{
+		FTracerSegment& Segment = Batch.Segments[SegmentIndex];
+
+		if (!Segment.bActive)
+		{
+			continue;
+		}
+
+		// The streak head travels from the start to the target, and the tail follows TracerLength behind.
+		const float TravelledDistance = TracerSpeed * (CurrentTime - Segment.StartTime);
+		const float HeadDistance = FMath::Min(TravelledDistance, Segment.Length);
+		const float TailDistance = FMath::Max(TravelledDistance - TracerLength, 0.0f);
+
+		// The tracer has arrived once its tail reaches the target.
+		if (TailDistance >= Segment.Length)
+		{
+			Segment.bActive = false;
+			--Batch.NumActiveSegments;
+
+			Batch.InstanceTransforms[SegmentIndex] = HiddenTransform;
+			continue;
+		}
+
+		const FVector StreakCentre = Segment.Start + Segment.Direction * (0.5f * (HeadDistance + TailDistance));
+		const float StreakScale = (HeadDistance - TailDistance) / Batch.MeshLength;
+
+		Batch.InstanceTransforms[SegmentIndex] = FTransform(Segment.Direction.ToOrientationQuat(), StreakCentre, FVector(StreakScale, 1.0f, 1.0f));
+	}
+
+	// One batched update for every tracer drawn by this component.
+	Batch.InstancedMeshComponent->BatchUpdateInstancesTransforms(0, Batch.InstanceTransforms, true, true, true);
+}
@@ -0,0 +1,320 @@
+// Toyan Green © 2020
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "AssaultRifle.h"
+#include "Shotgun.h"
+#include "GrenadeLauncher.h"
+#include "GrenadeLauncherProjectile.h"
+#include "NexusCharacter.h"
+#include "Nexus/Utils/Logging/NexusLogging.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Headless weapon fire benchmark.
+ *
+ * Run on a build machine with:
+ *		UE4Editor <Project> -game -nullrhi -unattended -ExecCmds="Automation RunTests Nexus.Performance.WeaponFire; Quit"
+ *
+ * Optional command line parameters:
+ *		-NexusBenchMap=		Map to load. (Default /Game/Maps/TestArena)
+ *		-NexusBenchCount=	Instances of each weapon class. (Default 16)
+ *		-NexusBenchFrames=	Frames to fire for. (Default 300)
+ *		-NexusBenchCSV=		Results file. (Default Saved/Automation/NexusWeaponBenchmark.csv)
+ *		-NexusBenchRifle=, -NexusBenchShotgun=, -NexusBenchLauncher=	Weapon blueprint class paths, used instead of the native classes.
+ *		-NexusBenchProjectile=	Projectile class path, for a grenade launcher without a projectile class. (Default AGrenadeLauncherProjectile)
+ *
+ * Each weapon class fires on its own, for the given number of frames plus one more frame in which the shotgun's async traces complete.
+ * Whole frames are measured, so the cost includes trace completion, projectiles and everything else a shot causes.
+ * An idle phase with no weapons firing is measured first, and its frame time is subtracted from each weapon class.
+ */
+
+/**
+ * \brief Results for one weapon class.
+ */
+struct FNexusWeaponBenchmarkResult
+{
+	FString WeaponName;
+	int32 NumInstances = 0;
+	uint64 NumShots = 0;
+	uint64 NumTraces = 0;
+	int32 NumFrames = 0;
+	double GameThreadSeconds = 0.0;
+};
+
+/**
+ * \brief State shared by the benchmark's latent commands.
+ */
+struct FNexusWeaponBenchmarkState
+{
+	FString CSVPath;
+	int32 NumInstancesPerClass = 16;
+	int32 NumFrames = 300;
+
+	/**
+	 * \brief The phase being measured. Phase 0 is idle, and each later phase fires one weapon class.
+	 */
+	int32 PhaseIndex = 0;
+	int32 PhaseFrame = 0;
+
+	TSubclassOf<AGrenadeLauncherProjectile> ProjectileClass;
+	TArray<TSubclassOf<ANexusWeapon>> WeaponClasses;
+	TArray<TArray<TWeakObjectPtr<ANexusWeapon>>> Weapons;
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+	FNexusWeaponBenchmarkResult IdleResult;
+	TArray<FNexusWeaponBenchmarkResult> Results;
+};
+
+/**
+ * \brief Access to the protected weapon fire path. Friend of ANexusWeapon and AGrenadeLauncher.
+ */
+struct FNexusWeaponBenchmark
+{
+	static void PrepareWeapon(ANexusWeapon& Weapon, TSubclassOf<AGrenadeLauncherProjectile> ProjectileClass)
+	{
+		// A grenade launcher without a projectile fires nothing. Set before BeginPlay, so the projectile pool is warmed.
+		AGrenadeLauncher* GrenadeLauncher = Cast<AGrenadeLauncher>(&Weapon);
+		if (GrenadeLauncher && !GrenadeLauncher->ProjectileClass)
+		{
+			GrenadeLauncher->ProjectileClass = ProjectileClass;
+		}
+	}
+
+	static void PrepareShot(ANexusWeapon& Weapon)
+	{
+		// Keep the clip full, so every shot goes down the full fire path instead of dry firing.
+		Weapon.CurrentAmmoInClip = Weapon.MaxAmmoPerClip;
+		Weapon.SetWeaponState(EWeaponState::Idle);
+	}
+
+	static void Fire(ANexusWeapon& Weapon)
+	{
+		Weapon.Fire();
+	}
+
+	static int32 GetTracesPerShot(const ANexusWeapon& Weapon)
+	{
+		return Weapon.GetHitScanTracesPerShot();
+	}
+};
+
+namespace NexusWeaponBenchmark
+{
+	UWorld* GetGameWorld()
+	{
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			if ((EWorldType::Game == WorldContext.WorldType || EWorldType::PIE == WorldContext.WorldType) && WorldContext.World())
+			{
+				return WorldContext.World();
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<class TClass>
+	TSubclassOf<TClass> GetClass(const TCHAR* ParameterName, TSubclassOf<TClass> NativeClass)
+	{
+		FString ClassPath;
+		if (FParse::Value(FCommandLine::Get(), ParameterName, ClassPath))
+		{
+			UClass* LoadedClass = LoadClass<TClass>(nullptr, *ClassPath);
+			if (LoadedClass)
+			{
+				return LoadedClass;
+			}
+		}
+
+		return NativeClass;
+	}
+}
+
+/**
+ * \brief Spawn the weapons and their dummy owners in the loaded map.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FNexusSpawnBenchmarkWeaponsCommand, TSharedRef<FNexusWeaponBenchmarkState>, State);
+
+bool FNexusSpawnBenchmarkWeaponsCommand::Update()
+{
+	UWorld* World = NexusWeaponBenchmark::GetGameWorld();
+	if (!World)
+	{
+		return true;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 ClassIndex = 0; ClassIndex < State->WeaponClasses.Num(); ++ClassIndex)
+	{
+		TArray<TWeakObjectPtr<ANexusWeapon>>& ClassWeapons = State->Weapons.AddDefaulted_GetRef();
+
+		FNexusWeaponBenchmarkResult& Result = State->Results.AddDefaulted_GetRef();
+		Result.WeaponName = State->WeaponClasses[ClassIndex]->GetName();
+		Result.NumInstances = State->NumInstancesPerClass;
+
+		for (int32 InstanceIndex = 0; InstanceIndex < State->NumInstancesPerClass; ++InstanceIndex)
+		{
+			// Owners stand in a grid, facing down the arena.
+			const FVector OwnerLocation(0.0f, 200.0f * InstanceIndex, 200.0f * (ClassIndex + 1));
+
+			ANexusCharacter* Owner = World->SpawnActor<ANexusCharacter>(ANexusCharacter::StaticClass(), OwnerLocation, FRotator::ZeroRotator, SpawnParameters);
+
+			const FTransform WeaponTransform(OwnerLocation);
+			ANexusWeapon* Weapon = World->SpawnActorDeferred<ANexusWeapon>(State->WeaponClasses[ClassIndex], WeaponTransform, Owner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (Weapon)
+			{
+				FNexusWeaponBenchmark::PrepareWeapon(*Weapon, State->ProjectileClass);
+				Weapon->FinishSpawning(WeaponTransform);
+			}
+
+			if (Owner && Weapon)
+			{
+				Weapon->SetOwningCharacter(Owner);
+				ClassWeapons.Add(Weapon);
+			}
+
+			State->SpawnedActors.Add(Owner);
+			State->SpawnedActors.Add(Weapon);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * \brief Measure an idle phase, then fire each weapon class once per frame in turn, measuring whole frames.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FNexusFireBenchmarkWeaponsCommand, TSharedRef<FNexusWeaponBenchmarkState>, State);
+
+bool FNexusFireBenchmarkWeaponsCommand::Update()
+{
+	FNexusWeaponBenchmarkResult* Result = 0 == State->PhaseIndex ? &State->IdleResult : &State->Results[State->PhaseIndex - 1];
+
+	// Game thread time is for the previous frame, so the first update of a phase has nothing to measure yet.
+	if (0 < State->PhaseFrame)
+	{
+		Result->GameThreadSeconds += FPlatformTime::ToSeconds(GGameThreadTime);
+		++Result->NumFrames;
+	}
+
+	// A phase measures its firing frames and one more frame, in which the async traces from the last shots complete.
+	if (State->NumFrames + 1 == State->PhaseFrame)
+	{
+		++State->PhaseIndex;
+		State->PhaseFrame = 0;
+
+		if (State->PhaseIndex > State->Weapons.Num())
+		{
+			return true;
+		}
+
+		Result = &State->Results[State->PhaseIndex - 1];
+	}
+
+	if (0 < State->PhaseIndex && State->PhaseFrame < State->NumFrames)
+	{
+		for (const TWeakObjectPtr<ANexusWeapon>& WeakWeapon : State->Weapons[State->PhaseIndex - 1])
+		{
+			ANexusWeapon* Weapon = WeakWeapon.Get();
+			if (!Weapon)
+			{
+				continue;
+			}
+
+			FNexusWeaponBenchmark::PrepareShot(*Weapon);
+			FNexusWeaponBenchmark::Fire(*Weapon);
+
+			++Result->NumShots;
+			Result->NumTraces += FNexusWeaponBenchmark::GetTracesPerShot(*Weapon);
+		}
+	}
+
+	++State->PhaseFrame;
+	return false;
+}
+
+/**
+ * \brief Write the results to the CSV file and the log, and destroy the spawned actors.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FNexusReportBenchmarkCommand, TSharedRef<FNexusWeaponBenchmarkState>, State);
+
+bool FNexusReportBenchmarkCommand::Update()
+{
+	const FNexusWeaponBenchmarkResult& IdleResult = State->IdleResult;
+	const double IdleFrameSeconds = 0 < IdleResult.NumFrames ? IdleResult.GameThreadSeconds / IdleResult.NumFrames : 0.0;
+
+	FString CSV = TEXT("Weapon,Instances,Frames,Shots,Traces,TracesPerSecond,MicrosecondsPerShot,AverageFrameMs,IdleFrameMs\n");
+
+	for (const FNexusWeaponBenchmarkResult& Result : State->Results)
+	{
+		// The cost of firing is the frame time above the idle phase.
+		const double FireSeconds = FMath::Max(Result.GameThreadSeconds - IdleFrameSeconds * Result.NumFrames, 0.0);
+
+		const double TracesPerSecond = 0.0 < FireSeconds ? Result.NumTraces / FireSeconds : 0.0;
+		const double MicrosecondsPerShot = 0 < Result.NumShots ? FireSeconds * 1000000.0 / Result.NumShots : 0.0;
+		const double AverageFrameMilliseconds = 0 < Result.NumFrames ? Result.GameThreadSeconds * 1000.0 / Result.NumFrames : 0.0;
+
+		const FString Row = FString::Printf(TEXT("%s,%d,%d,%llu,%llu,%.1f,%.3f,%.3f,%.3f"), *Result.WeaponName, Result.NumInstances, Result.NumFrames,
+			Result.NumShots, Result.NumTraces, TracesPerSecond, MicrosecondsPerShot, AverageFrameMilliseconds, IdleFrameSeconds * 1000.0);
+
+		FNexusLogging::Log(ELogLevel::INFO, FString::Printf(TEXT("Weapon benchmark: %s"), *Row));
+
+		CSV += Row + TEXT("\n");
+	}
+
+	if (!FFileHelper::SaveStringToFile(CSV, *State->CSVPath))
+	{
+		FNexusLogging::Log(ELogLevel::ERROR, FString::Printf(TEXT("Weapon benchmark could not write %s"), *State->CSVPath));
+	}
+
+	for (const TWeakObjectPtr<AActor>& SpawnedActor : State->SpawnedActors)
+	{
+		if (SpawnedActor.IsValid())
+		{
+			SpawnedActor->Destroy();
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNexusWeaponFireBenchmarkTest, "Nexus.Performance.WeaponFire",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FNexusWeaponFireBenchmarkTest::RunTest(const FString& Parameters)
+{
+	TSharedRef<FNexusWeaponBenchmarkState> State = MakeShared<FNexusWeaponBenchmarkState>();
+
+	FString MapName = TEXT("/Game/Maps/TestArena");
+	FParse::Value(FCommandLine::Get(), TEXT("NexusBenchMap="), MapName);
+	FParse::Value(FCommandLine::Get(), TEXT("NexusBenchCount="), State->NumInstancesPerClass);
+	FParse::Value(FCommandLine::Get(), TEXT("NexusBenchFrames="), State->NumFrames);
+
+	State->CSVPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("NexusWeaponBenchmark.csv"));
+	FParse::Value(FCommandLine::Get(), TEXT("NexusBenchCSV="), State->CSVPath);
+
+	State->WeaponClasses.Add(NexusWeaponBenchmark::GetClass<ANexusWeapon>(TEXT("NexusBenchRifle="), AAssaultRifle::StaticClass()));
+	State->WeaponClasses.Add(NexusWeaponBenchmark::GetClass<ANexusWeapon>(TEXT("NexusBenchShotgun="), AShotgun::StaticClass()));
+	State->WeaponClasses.Add(NexusWeaponBenchmark::GetClass<ANexusWeapon>(TEXT("NexusBenchLauncher="), AGrenadeLauncher::StaticClass()));
+	State->ProjectileClass = NexusWeaponBenchmark::GetClass<AGrenadeLauncherProjectile>(TEXT("NexusBenchProjectile="), AGrenadeLauncherProjectile::StaticClass());
+
+	AutomationOpenMap(MapName);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FNexusSpawnBenchmarkWeaponsCommand(State));
+	ADD_LATENT_AUTOMATION_COMMAND(FNexusFireBenchmarkWeaponsCommand(State));
+	ADD_LATENT_AUTOMATION_COMMAND(FNexusReportBenchmarkCommand(State));
+
+	return true;
+}
+
+#endif
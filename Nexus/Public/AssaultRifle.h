@@ -27,5 +27,11 @@ protected:
 	 * \brief Shoot the weapon.
 	 */
 	virtual void Fire() override;
+
+	/**
+	 * \brief Get the number of hit scan traces fired per shot.
+	 * \return The number of traces per shot.
+	 */
+	virtual int32 GetHitScanTracesPerShot() const override { return 1; }
 	
 };
@@ -0,0 +1,63 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "NexusCrowdSkeletalMeshComponent.generated.h"
+
+struct FAnimUpdateRateParameters;
+
+/**
+ * \brief Skeletal mesh for crowd characters, which updates and evaluates its animation less often the smaller it is on screen.
+ * Skipped frames are interpolated, and meshes that are not rendered update at a fixed low rate. Only used on clients, so server hitboxes stay current.
+ */
+UCLASS( ClassGroup=(Nexus), meta=(BlueprintSpawnableComponent) )
+class NEXUS_API UNexusCrowdSkeletalMeshComponent : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UNexusCrowdSkeletalMeshComponent();
+
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/**
+	 * \brief Check if the mesh is close enough to use detailed animation, such as IK and aim offsets.
+	 * \return true if the animation is updated every frame.
+	 */
+	bool ShouldUseDetailedAnimation() const;
+
+protected:
+
+	// Called when the component is registered
+	virtual void OnRegister() override;
+
+	/**
+	 * \brief Screen size thresholds for each step down in animation rate. (e.g. 0.3 = update every 2nd frame below 30% screen size)
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Optimization")
+	TArray<float> VisibleScreenSizeThresholds;
+
+	/**
+	 * \brief Rate the animation updates while the mesh is not rendered. (e.g. 4 = every 4th frame)
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Optimization", meta = (ClampMin = 1))
+	int32 NonRenderedUpdateRate = 8;
+
+	/**
+	 * \brief Skipped frames are interpolated while the evaluation rate is at most this; slower rates snap between poses.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Optimization", meta = (ClampMin = 1))
+	int32 MaxEvaluationRateForInterpolation = 4;
+
+private:
+
+	/**
+	 * \brief Apply the crowd thresholds to the update rate parameters, when they are created.
+	 * \param UpdateRateParameters The mesh's update rate parameters.
+	 */
+	void SetupUpdateRateParameters(FAnimUpdateRateParameters* UpdateRateParameters) const;
+};
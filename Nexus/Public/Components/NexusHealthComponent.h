@@ -52,6 +52,11 @@ public:
 	 */
 	void RestoreArmour(float ArmourAmount);
 
+	/**
+	 * \brief Restore full health and remove armour, as when the owner was spawned. Used to reuse a dead owner.
+	 */
+	void ResetHealth();
+
 	/**
 	 * \brief Check if actors are on the same team.
 	 * \param Actor1 
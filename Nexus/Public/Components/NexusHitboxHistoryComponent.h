@@ -0,0 +1,157 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "NexusHitboxHistoryComponent.generated.h"
+
+class UPrimitiveComponent;
+struct FBodyInstance;
+
+/**
+ * \brief Records the physics bodies (hit volumes) of a primitive component in a fixed size ring buffer on the server.
+ * Used by UNexusLagCompensationSubsystem to rewind hit volumes to the time a client fired.
+ */
+UCLASS( ClassGroup=(Nexus), meta=(BlueprintSpawnableComponent) )
+class NEXUS_API UNexusHitboxHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UNexusHitboxHistoryComponent();
+
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/**
+	 * \brief Set the component whose physics bodies are recorded.
+	 * \param NewHitboxComponent Skeletal mesh (one hit volume per physics body) or any other primitive (single hit volume).
+	 */
+	void SetHitboxComponent(UPrimitiveComponent* NewHitboxComponent);
+
+	/**
+	 * \brief Move the hit volumes to where they were at the given time. Current transforms are stored so they can be restored.
+	 * \param RewindTime The world time to rewind to.
+	 * \return true if the hit volumes were moved.
+	 */
+	bool RewindHitboxes(float RewindTime);
+
+	/**
+	 * \brief Move the hit volumes back to where they were before they were rewound.
+	 */
+	void RestoreHitboxes();
+
+	/**
+	 * \brief Discard all recorded snapshots. Used when the hit volumes should no longer be rewound, e.g. when the owner dies.
+	 */
+	void ClearHistory();
+
+	/**
+	 * \brief Start or stop recording snapshots. Stopping discards the history. Recording only starts where the history is needed, on a server with remote clients.
+	 * \param bEnabled Should snapshots be recorded.
+	 */
+	void SetRecordingEnabled(bool bEnabled);
+
+	/**
+	 * \brief Get the number of hit volumes recorded per snapshot.
+	 * \return Number of hit volumes.
+	 */
+	int32 GetNumHitboxes() const;
+
+protected:
+
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called when the component is removed from play
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * \brief The number of snapshots kept in the ring buffer. Should cover the maximum rewind time at the server tick rate.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "LagCompensation", meta = (ClampMin = 2))
+	int32 MaxSnapshots = 32;
+
+	/**
+	 * \brief The maximum number of hit volumes recorded per snapshot.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "LagCompensation", meta = (ClampMin = 1))
+	int32 MaxHitboxes = 32;
+
+private:
+
+	/**
+	 * \brief World space pose of a hit volume.
+	 */
+	struct FHitboxPose
+	{
+		FQuat Rotation;
+		FVector Location;
+	};
+
+	/**
+	 * \brief Get the physics body for a hit volume.
+	 * \param HitboxIndex Index of the hit volume.
+	 * \return The body instance, or null if it does not exist.
+	 */
+	FBodyInstance* GetHitboxBody(int32 HitboxIndex) const;
+
+	/**
+	 * \brief Count the physics bodies on the hitbox component.
+	 * \return Number of bodies, clamped to MaxHitboxes.
+	 */
+	int32 CountHitboxBodies() const;
+
+	/**
+	 * \brief Allocate the snapshot storage for the current number of hit volumes.
+	 */
+	void AllocateHistory();
+
+	/**
+	 * \brief Store the current pose of every hit volume in the next ring buffer slot.
+	 */
+	void RecordSnapshot();
+
+	/**
+	 * \brief The component whose physics bodies are recorded.
+	 */
+	UPROPERTY()
+	UPrimitiveComponent* HitboxComponent;
+
+	/**
+	 * \brief World time of each snapshot in the ring buffer.
+	 */
+	TArray<float> SnapshotTimes;
+
+	/**
+	 * \brief Hit volume poses for every snapshot, stored contiguously per snapshot. (MaxSnapshots * NumHitboxes)
+	 */
+	TArray<FHitboxPose> SnapshotPoses;
+
+	/**
+	 * \brief Hit volume poses from before the last rewind.
+	 */
+	TArray<FHitboxPose> RestorePoses;
+
+	/**
+	 * \brief The number of hit volumes recorded per snapshot.
+	 */
+	int32 NumHitboxes = 0;
+
+	/**
+	 * \brief Ring buffer index of the most recent snapshot.
+	 */
+	int32 NewestSnapshotIndex = INDEX_NONE;
+
+	/**
+	 * \brief The number of valid snapshots in the ring buffer.
+	 */
+	int32 NumRecordedSnapshots = 0;
+
+	/**
+	 * \brief Used to track if the hit volumes are currently rewound.
+	 */
+	bool bHitboxesRewound = false;
+};
@@ -7,7 +7,6 @@
 #include "ExplodingBarrel.generated.h"
 
 class UNexusHealthComponent;
-class URadialForceComponent;
 
 UCLASS()
 class NEXUS_API AExplodingBarrel : public AActor
@@ -60,12 +59,6 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UNexusHealthComponent* BarrelHealthComponent;
 
-	/**
-	 * \brief Component used to emit radial force when the barrel explodes.
-	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
-	URadialForceComponent* RadialForceComponent;
-
 	/**
 	 * \brief Particle effect spawned at the barrel's location when it explodes.
 	 */
@@ -4,15 +4,16 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "Interfaces/NexusSignificanceInterface.h"
 #include "ExplodingEnemy.generated.h"
 
 class UNexusHealthComponent;
-class URadialForceComponent;
+class UNexusHitboxHistoryComponent;
 class USphereComponent;
 class USoundCue;
 
 UCLASS()
-class NEXUS_API AExplodingEnemy : public APawn
+class NEXUS_API AExplodingEnemy : public APawn, public INexusSignificanceInterface
 {
 	GENERATED_BODY()
 
@@ -29,11 +30,20 @@ public:
 	 *	@note Components on both this and the other Actor must have bGenerateOverlapEvents set to true to generate overlap events.
 	 */
 	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+
+	/**
+	 * \brief Pause the movement sound effect while the enemy is culled.
+	 * \param NewTier The enemy's new significance tier.
+	 */
+	virtual void OnSignificanceChanged(ENexusSignificanceTier NewTier) override;
 	
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the enemy is removed from the level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/**
 	 * \brief Respond to a change in health. Wired up to health components OnHealthChanged event. Uses the signature for FOnHealthChangedSignature.
 	 * \param HealthComponent The health component the experienced a health change.
@@ -58,6 +68,11 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "ExplodingEnemy")
 	void Explode();
 
+	/**
+	 * \brief Destroy the enemy once its explosion has been applied.
+	 */
+	void OnExplosionApplied();
+
 	/**
 	 * \brief Replicate enemy explosion effects.
 	 */
@@ -87,13 +102,13 @@ protected:
 	 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UNexusHealthComponent* EnemyHealthComponent;
-	
+
 	/**
-	 * \brief Component used to emit radial force when the enemy explodes.
+	 * \brief Component used to record hitbox history for lag compensation.
 	 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
-	URadialForceComponent* RadialForceComponent;
-
+	UNexusHitboxHistoryComponent* HitboxHistoryComponent;
+	
 	/**
 	 * \brief Collision sphere used to detect nearby actors.
 	 */
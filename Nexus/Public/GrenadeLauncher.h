@@ -7,6 +7,8 @@
 #include "GrenadeLauncherProjectile.h"
 #include "GrenadeLauncher.generated.h"
 
+struct FNexusWeaponBenchmark;
+
 /**
  * 
  */
@@ -15,6 +17,8 @@ class NEXUS_API AGrenadeLauncher : public ANexusWeapon
 {
 	GENERATED_BODY()
 
+	friend struct FNexusWeaponBenchmark;
+
 public:
 
 	/**
@@ -36,8 +40,23 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	float DamageRadius;
 
+	/**
+	 * \brief The number of projectiles spawned into the projectile pool when the weapon begins play.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", meta = (ClampMin = 0))
+	int32 NumPooledProjectiles = 4;
+
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
 	/**
 	 * \brief Shoot the weapon.
 	 */
 	virtual void Fire() override;
+
+	/**
+	 * \brief Take a projectile from the pool and launch it from the muzzle.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 */
+	void FireProjectile(AActor* WeaponOwner);
 };
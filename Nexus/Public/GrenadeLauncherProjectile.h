@@ -4,13 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Interfaces/NexusPoolableActor.h"
 #include "GrenadeLauncherProjectile.generated.h"
 
 class UProjectileMovementComponent;
 class USphereComponent;
 
 UCLASS()
-class NEXUS_API AGrenadeLauncherProjectile : public AActor
+class NEXUS_API AGrenadeLauncherProjectile : public AActor, public INexusPoolableActor
 {
 	GENERATED_BODY()
 	
@@ -34,6 +35,16 @@ public:
 	void SetDamageRadius(float Radius);
 
 	void SetDamageType(TSubclassOf<UDamageType> Type);
+
+	/**
+	 * \brief Reset movement and lifespan, and show the projectile. Called when the projectile is fired from the pool.
+	 */
+	virtual void OnAcquiredFromPool() override;
+
+	/**
+	 * \brief Stop movement, clear the lifespan and damage parameters, and hide the projectile. Called when the projectile is returned to the pool.
+	 */
+	virtual void OnReleasedToPool() override;
 	
 protected:
 
@@ -71,6 +82,23 @@ protected:
 	 * \brief Spawn particle effect for explosion.
 	 */
 	void PlayExplosionEffect() const;
+
+	/**
+	 * \brief Replicate the projectile being fired from, or returned to, the pool.
+	 */
+	UFUNCTION()
+	void OnRep_PoolActive();
+
+	/**
+	 * \brief Show and move the projectile while it is in flight, hide and stop it while it is pooled.
+	 */
+	void ApplyPoolActiveState();
+
+	/**
+	 * \brief Is the projectile in flight. False while it is waiting in the pool.
+	 */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_PoolActive)
+	bool bPoolActive;
 	
 private:
 
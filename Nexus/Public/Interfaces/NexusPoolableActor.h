@@ -0,0 +1,38 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "NexusPoolableActor.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UNexusPoolableActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * \brief Implemented by actors that can be reused by UNexusActorPoolSubsystem, instead of being spawned and destroyed.
+ */
+class NEXUS_API INexusPoolableActor
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * \brief Called when the actor is taken from the pool, after it has been moved to its spawn transform. Should reset and activate the actor.
+	 */
+	virtual void OnAcquiredFromPool() {}
+
+	/**
+	 * \brief Called when the actor is returned to the pool. Should deactivate the actor (hide it, disable collision, stop movement and timers).
+	 */
+	virtual void OnReleasedToPool() {}
+
+	/**
+	 * \brief Called on actors spawned straight into the pool, before they are constructed and begin play. Should stop the actor starting up active.
+	 */
+	virtual void OnSpawnedIntoPool() {}
+};
@@ -0,0 +1,42 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "NexusSignificanceInterface.generated.h"
+
+/**
+ * \brief How much an actor matters to the nearest player. Lower tiers tick less often and drop cosmetic work.
+ */
+enum class ENexusSignificanceTier : uint8
+{
+	High,
+	Medium,
+	Low,
+	Culled,
+	Num
+};
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UNexusSignificanceInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * \brief Implemented by actors registered with UNexusSignificanceSubsystem, so they can scale their cosmetic work with their significance.
+ */
+class NEXUS_API INexusSignificanceInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * \brief Called when the actor moves to a new significance tier, after its tick interval has been updated.
+	 * Gameplay that must stay correct at any tick rate (pathing, timers, hit registration) should not be disabled here.
+	 * \param NewTier The actor's new significance tier.
+	 */
+	virtual void OnSignificanceChanged(ENexusSignificanceTier NewTier) {}
+};
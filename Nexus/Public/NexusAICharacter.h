@@ -4,17 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "NexusCharacter.h"
+#include "Interfaces/NexusPoolableActor.h"
 #include "NexusAICharacter.generated.h"
 
 class UAIPerceptionComponent;
 
 UCLASS()
-class NEXUS_API ANexusAICharacter : public ANexusCharacter
+class NEXUS_API ANexusAICharacter : public ANexusCharacter, public INexusPoolableActor
 {
 	GENERATED_BODY()
 
 public:
-	ANexusAICharacter();
+	ANexusAICharacter(const FObjectInitializer& ObjectInitializer);
 
 	virtual void StopShooting() override;
 
@@ -23,10 +24,47 @@ public:
 	 * \return Score value.
 	 */
 	float GetScoreValue() const;
+
+	/**
+	 * \brief Check if the enemy is waiting in the enemy pool, rather than in play.
+	 * \return true - pooled, false - in play.
+	 */
+	bool IsPooled() const;
+
+	/**
+	 * \brief Revive the enemy, give it a new appearance and restart its AI.
+	 */
+	virtual void OnAcquiredFromPool() override;
+
+	/**
+	 * \brief Hide the dead enemy and stop its AI, keeping its weapons for reuse.
+	 */
+	virtual void OnReleasedToPool() override;
+
+	/**
+	 * \brief Start the enemy hidden and inactive, so it does not randomize its appearance or start its AI until it is acquired.
+	 */
+	virtual void OnSpawnedIntoPool() override;
+
+	/**
+	 * \brief Enemies spawned into the pool only get an AI controller when they are acquired.
+	 */
+	virtual void SpawnDefaultController() override;
 	
 protected:
 
 	virtual void BeginPlay() override;
+
+	/**
+	 * \brief Return the dead enemy to the pool, rather than destroying it, if the game mode reuses enemies of its class.
+	 */
+	virtual void LifeSpanExpired() override;
+
+	/**
+	 * \brief Enemies returned to the pool keep their weapons, so they are reused together.
+	 * \return true if the enemy will be destroyed rather than pooled.
+	 */
+	virtual bool ShouldDestroyWeaponOnDeath() const override;
 	
 	/**
 	 * \brief Component used to give AI senses. (Sight etc.)
@@ -88,6 +126,24 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Enemy")
 	TArray<UMaterialInstance*> MaskMaterials;
 
+	/**
+	 * \brief Hair meshes skinned to the character's skeleton. When set, hair is merged into the character mesh instead of attached.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Enemy")
+	TArray<USkeletalMesh*> SkinnedHairMeshes;
+
+	/**
+	 * \brief Beard meshes skinned to the character's skeleton. When set, beards are merged into the character mesh instead of attached.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Enemy")
+	TArray<USkeletalMesh*> SkinnedBeardMeshes;
+
+	/**
+	 * \brief Mask/helmet meshes skinned to the character's skeleton. When set, masks are merged into the character mesh instead of attached.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Enemy")
+	TArray<USkeletalMesh*> SkinnedMaskMeshes;
+
 	/**
 	 * \brief Sound effect spawned at the character's location when they are hurt and the easter egg is active.
 	 */
@@ -101,6 +157,54 @@ protected:
 	USoundBase* EasterEggDeathSFX;
 
 private:
+
+	/**
+	 * \brief Pick a random mesh, materials and appearance parts for the character.
+	 */
+	void RandomizeAppearance();
+
+	/**
+	 * \brief Check if the enemy is returned to the pool when its life span expires.
+	 * \return true if the enemy is pooled, false if it is destroyed.
+	 */
+	bool ShouldReturnToPool() const;
+
+	/**
+	 * \brief Replicate the enemy being taken from, or returned to, the pool.
+	 */
+	UFUNCTION()
+	void OnRep_PoolActive();
+
+	/**
+	 * \brief Show and revive the enemy while it is in play, hide it and stop it updating while it is pooled.
+	 */
+	void ApplyPoolActiveState();
+
+	/**
+	 * \brief Is the enemy in play. False while it is waiting in the pool.
+	 */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_PoolActive)
+	bool bPoolActive = true;
+
+	/**
+	 * \brief The AI controller that possessed the enemy before it was pooled, kept so it does not have to be spawned again.
+	 */
+	UPROPERTY(Transient)
+	AController* PooledController;
+
+	/**
+	 * \brief Replace the character mesh with the character mesh merged with the appearance parts.
+	 * Only hair, beard and mask parts from the Skinned* arrays are merged. Armour and bag stay as attachments, as they are shown and hidden during play.
+	 * \param Parts Appearance parts skinned to the character's skeleton.
+	 * \param PartMaterials Material applied to each part. (nullptr = the part's own material)
+	 */
+	void MergeAppearanceParts(const TArray<USkeletalMesh*>& Parts, const TArray<UMaterialInterface*>& PartMaterials);
+
+	/**
+	 * \brief Destroy an attachment component that has been replaced by a merged appearance part.
+	 * \param MeshComponent The attachment component. Set to nullptr.
+	 */
+	void DestroyAttachment(UStaticMeshComponent*& MeshComponent);
 	
 	virtual void PlayHurtSFX() const override;
 	virtual void PlayDeathSFX() const override;
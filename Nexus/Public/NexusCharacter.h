@@ -5,35 +5,31 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "NexusWeapon.h"
+#include "Interfaces/NexusSignificanceInterface.h"
 #include "NexusCharacter.generated.h"
 
-class UCameraComponent;
-class USpringArmComponent;
 class UNexusHealthComponent;
-class USceneCaptureComponent2D;
+class UNexusHitboxHistoryComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnADSUpdatedSignature, ANexusCharacter*, Character, bool, bAmingDownSights);
 
 UCLASS()
-class NEXUS_API ANexusCharacter : public ACharacter
+class NEXUS_API ANexusCharacter : public ACharacter, public INexusSignificanceInterface
 {
 	GENERATED_BODY()
 
 public:
 	// Sets default values for this character's properties
-	ANexusCharacter();
+	ANexusCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-	// Called to bind functionality to input
-	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
-
 	/**
-	 * \brief Return characters eye location.
-	 * \return Eye location
+	 * \brief Reduce the animation and cosmetic cost of characters the players are not close to.
+	 * \param NewTier The character's new significance tier.
 	 */
-	virtual FVector GetPawnViewLocation() const override;
+	virtual void OnSignificanceChanged(ENexusSignificanceTier NewTier) override;
 
 	/**
 	 * \brief Make the character jump on the next update, or stand from crouching.
@@ -65,6 +61,20 @@ public:
 	 */
 	float GetAimYaw() const;
 
+	/**
+	 * \brief Get the angles the character's aim is moving towards. Characters without a controller use the angles replicated by the server.
+	 * \param PitchOut Target pitch rotation angle.
+	 * \param YawOut Target yaw rotation angle.
+	 */
+	void GetTargetAimAngles(float& PitchOut, float& YawOut) const;
+
+	/**
+	 * \brief Set the smoothed aim angles used for aim anim offset. Called by the character aim subsystem.
+	 * \param Pitch Smoothed pitch rotation angle.
+	 * \param Yaw Smoothed yaw rotation angle.
+	 */
+	void SetSmoothedAimAngles(float Pitch, float Yaw);
+
 	/**
 	 * \brief Check if the character's left hand should be using IK.
 	 * \return true - use IK, false - no IK.
@@ -173,6 +183,9 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the character is removed from the level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/**
 	 * \brief Moves the character forward or backward, depending on axis value.
 	 * \param fAxisValue Value of the input axis.
@@ -250,22 +263,26 @@ protected:
 	virtual void PlayDeathSFX() const;
 
 	/**
-	 * \brief Third person camera component
+	 * \brief Return a dead character to the state it spawned in, so it can be reused instead of respawned.
+	 * Resets the ragdoll, collision and movement on every machine. The server authority also restores health and ammo.
 	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
-	UCameraComponent* CameraComponent;
+	void Revive();
 
 	/**
-	 * \brief Component used to capture character to render in UI.
+	 * \brief Register with the subsystems that update the character, i.e. significance and aim. Called in BeginPlay.
 	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
-	USceneCaptureComponent2D* CharacterCaptureComponent;
+	void RegisterWithSubsystems();
 
 	/**
-	 * \brief Component used to mount the camera.
+	 * \brief Unregister from the subsystems that update the character. Called in EndPlay.
 	 */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
-	USpringArmComponent* SpringArmComponent;
+	void UnregisterFromSubsystems();
+
+	/**
+	 * \brief Check if the character's weapon is destroyed with the character when it dies.
+	 * \return true if the weapon is destroyed.
+	 */
+	virtual bool ShouldDestroyWeaponOnDeath() const;
 
 	/**
 	 * \brief Component used to manage health.
@@ -273,6 +290,12 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UNexusHealthComponent* CharacterHealthComponent;
 
+	/**
+	 * \brief Component used to record hitbox history for lag compensation.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UNexusHitboxHistoryComponent* HitboxHistoryComponent;
+
 	/**
 	 * \brief Visible mesh component for armour.
 	 */
@@ -316,16 +339,10 @@ protected:
 	ANexusWeapon* OffHandWeapon;
 
 	/**
-	 * \brief Field of view value for aiming down sights.
+	 * \brief The change in degrees needed before the aim angles are replicated again. Simulated proxies smooth between updates.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player")
-	float AimingFOV = 65.0f;
-
-	/**
-	 * \brief Speed of the aim down sight interpolation.
-	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player", meta = (ClampMin = 0.1, ClampMax = 100))
-	float ADSInterpolationSpeed = 20.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player", meta = (ClampMin = 0, ClampMax = 10))
+	float AimReplicationThreshold = 1.0f;
 
 	/**
 	 * \brief Primary weapon that the character should spawn with.
@@ -399,12 +416,6 @@ protected:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	FName OffHandWeapon1SocketName = "Weapon1Socket";
 
-	/**
-	 * \brief Name of the socket used to attach facecam to character's head.
-	 */
-	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	FName FaceCamSocketName = "head";
-
 	/**
 	 * \brief Name of the socket used to attach objects to character's head.
 	 */
@@ -426,16 +437,9 @@ protected:
 private:
 
 	/**
-	 * \brief Set the camera field of view to set aim zoom.
-	 * \param DeltaTime Time since last update.
+	 * \brief Quantize the aim angles for replication, if they have changed by more than the threshold since they were last replicated.
 	 */
-	void SetAimDownSight(float DeltaTime);
-
-	/**
-	 * \brief Set the aim angle values used for aim anim offset.
-	 * \param DeltaTime Time since last update.
-	 */
-	void SetAimAngles(float DeltaTime);
+	void UpdateReplicatedAimAngles();
 
 	/**
 	 * \brief Spawn sound effect for character crouching.
@@ -472,16 +476,28 @@ private:
 	 */
 	void AttachWeaponToSocket(ANexusWeapon*& Weapon, const FName& SocketName);
 
+	/**
+	 * \brief Stop a mesh simulating as a ragdoll and restore its default physics and collision settings.
+	 * \param RagdollMesh The mesh to reset.
+	 */
+	void ResetRagdollMesh(USkeletalMeshComponent* RagdollMesh) const;
+
 	/**
 	 * \brief Set the current visibility of the characters armour.
 	 */
 	void SetArmourVisibility();
-	
+
 	/**
-	 * \brief Default FOV value for the camera, cached on begin play.
+	 * \brief Enable or disable shadows cast by the attached cosmetic meshes.
+	 * \param bCastShadows Should the meshes cast shadows, if their defaults do.
 	 */
-	float DefaultFOV;
+	void SetCosmeticShadowsEnabled(bool bCastShadows);
 
+	/**
+	 * \brief Animation tick option set on the mesh, restored when the character becomes significant again.
+	 */
+	EVisibilityBasedAnimTickOption DefaultVisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	
 	/**
 	 * \brief Used to toggle the ADS zoom.
 	 */
@@ -495,77 +511,47 @@ private:
 	bool bDead;
 
 	/**
-	 * \brief The pitch rotation angle of the character's aim.
+	 * \brief The pitch rotation angle of the character's aim. Set by the server authority.
 	 */
-	UPROPERTY(Replicated)
 	float AimPitchAngle;
 	
 	/**
-	 * \brief The yaw rotation angle of the character's aim.
+	 * \brief The yaw rotation angle of the character's aim. Set by the server authority.
 	 */
-	UPROPERTY(Replicated)
 	float AimYawAngle;
 
 	/**
-	 * \brief Default maximum walk speed, cached on begin play.
-	 */
-	float DefaultMaxWalkSpeed;
-
-	/**
-	 * \brief Default maximum crouch speed, cached on begin play.
-	 */
-	float DefaultMaxCrouchSpeed;
-		
-	/**
-	 * \brief Name used for move forward input binding.
-	 */
-	const FName MoveForwardBindingName = "MoveForward";
-
-	/**
-	 * \brief Name used for move right input binding.
+	 * \brief The pitch rotation angle of the character's aim, quantized to 16 bits for replication.
 	 */
-	const FName MoveRightBindingName = "MoveRight";
-
-	/**
-	 * \brief Name used for look up input binding.
-	 */
-	const FName LookUpBindingName = "LookUp";
-
-	/**
-	 * \brief Name used for turn input binding.
-	 */
-	const FName TurnBindingName = "Turn";
-
-	/**
-	 * \brief Name used for crouch input binding.
-	 */
-	const FName CrouchBindingName = "Crouch";
+	UPROPERTY(Replicated)
+	uint16 ReplicatedAimPitch;
 
 	/**
-	 * \brief Name used for jump input binding.
+	 * \brief The yaw rotation angle of the character's aim, quantized to 16 bits for replication.
 	 */
-	const FName JumpBindingName = "Jump";
+	UPROPERTY(Replicated)
+	uint16 ReplicatedAimYaw;
 
 	/**
-	 * \brief Name used for aiming input binding.
+	 * \brief The smoothed pitch rotation angle of the character's aim. Not used on a dedicated server.
 	 */
-	const FName AimingBindingName = "AimDownSight";
+	float SmoothedAimPitchAngle;
 
 	/**
-	 * \brief Name used for shooting input binding.
+	 * \brief The smoothed yaw rotation angle of the character's aim. Not used on a dedicated server.
 	 */
-	const FName ShootBindingName = "Fire";
+	float SmoothedAimYawAngle;
 
 	/**
-	 * \brief Name used for reload input binding.
+	 * \brief Default maximum walk speed, cached on begin play.
 	 */
-	const FName ReloadBindingName = "Reload";
+	float DefaultMaxWalkSpeed;
 
 	/**
-	 * \brief Name used for swap weapon input binding.
+	 * \brief Default maximum crouch speed, cached on begin play.
 	 */
-	const FName SwapWeaponBindingName = "SwapWeapon";
-
+	float DefaultMaxCrouchSpeed;
+		
 	/**
 	 * \brief Weighting used to blend between ragdoll physics and animation.
 	 */
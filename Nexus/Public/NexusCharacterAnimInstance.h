@@ -4,25 +4,104 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "NexusCharacterAnimInstance.generated.h"
 
+class ANexusCharacter;
+class UNexusCharacterAnimInstance;
+class UNexusCrowdSkeletalMeshComponent;
+
+/**
+ * \brief Character state gathered on the game thread, once per frame, for the animation update.
+ */
+struct FNexusCharacterAnimData
+{
+	FVector Velocity = FVector::ZeroVector;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FTransform LeftHandWeaponIKSocketTransform;
+	float AimPitch = 0.0f;
+	float AimYaw = 0.0f;
+	bool bJumpEnabled = false;
+	bool bInAir = false;
+	bool bCrouching = false;
+	bool bDead = false;
+	bool bAimingDownSights = false;
+	bool bLeftHandHoldingWeapon = false;
+	bool bDetailedAnimation = true;
+};
+
+/**
+ * \brief Updates the character animation variables on an animation worker thread.
+ * Only PreUpdate touches the character, on the game thread. The rest of the update works on the gathered data.
+ */
+USTRUCT()
+struct NEXUS_API FNexusCharacterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FNexusCharacterAnimInstanceProxy() = default;
+
+	FNexusCharacterAnimInstanceProxy(UAnimInstance* InAnimInstance)
+		: FAnimInstanceProxy(InAnimInstance)
+	{
+	}
+
+protected:
+
+	virtual void Initialize(UAnimInstance* InAnimInstance) override;
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+
+	/**
+	 * \brief Get the angle of the velocity relative to the rotation, as used by blend spaces. Matches UAnimInstance::CalculateDirection.
+	 * \return Direction in degrees, between -180 and 180.
+	 */
+	static float CalculateDirection(const FVector& Velocity, const FRotator& BaseRotation);
+
+	/**
+	 * \brief The anim instance that owns this proxy. Its animation variables are written by Update, before the anim graph reads them.
+	 */
+	UNexusCharacterAnimInstance* NexusAnimInstance = nullptr;
+
+	/**
+	 * \brief The character being animated, cached when the animation is initialized. Only used on the game thread.
+	 */
+	ANexusCharacter* Character = nullptr;
+
+	/**
+	 * \brief The character's crowd mesh, if it uses one. Crowd meshes drop detailed animation at a distance.
+	 */
+	const UNexusCrowdSkeletalMeshComponent* CrowdMesh = nullptr;
+
+	/**
+	 * \brief Character state gathered this frame.
+	 */
+	FNexusCharacterAnimData AnimData;
+};
+
 /**
- * 
+ * \brief Character animation instance. The animation variables are updated by FNexusCharacterAnimInstanceProxy, off the game thread.
  */
 UCLASS()
 class NEXUS_API UNexusCharacterAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
 
+	friend struct FNexusCharacterAnimInstanceProxy;
+
 public:
 	
 	UNexusCharacterAnimInstance();
 
-	virtual void NativeInitializeAnimation() override;
+protected:
 
-	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 
-protected:
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
 
 	/**
 	 * \brief Used to track if the character jumped.
@@ -78,6 +157,12 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
 	float AimYaw;
 
+	/**
+	 * \brief Used to skip the aim offset when the character is too small on screen for it to be noticed.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	bool bAimOffsetEnabled;
+
 	/**
 	 * \brief Used to track if the character left hand should be use IK.
 	 */
@@ -93,7 +178,8 @@ protected:
 private:
 	
 	/**
-	 * \brief Pointer to the pawn this anim instance is used by
+	 * \brief Proxy used to update the animation variables. Owned by this instance, rather than allocated by the engine.
 	 */
-	APawn* Owner;
+	UPROPERTY(Transient)
+	FNexusCharacterAnimInstanceProxy Proxy;
 };
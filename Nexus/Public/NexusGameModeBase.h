@@ -7,6 +7,7 @@
 #include "NexusGameModeBase.generated.h"
 
 enum class EWaveState : uint8;
+class ANexusAICharacter;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnActorKilled, AActor*, KilledActor, AController*, InstigatingController, AActor*, DeathCauser);
 
@@ -26,6 +27,13 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnActorKilled OnActorKilled;
 
+	/**
+	 * \brief Check if dead enemies of a class are returned to the enemy pool. Only the pooled enemy class is taken back out of the pool, so other enemies are destroyed.
+	 * \param EnemyClass The class of the enemy.
+	 * \return true if the enemy should be returned to the pool.
+	 */
+	bool IsPooledEnemyClass(const UClass* EnemyClass) const;
+
 protected:
 
 	/**
@@ -34,11 +42,28 @@ protected:
 	virtual void BeginPlay() override;
 	
 	/**
-	 * \brief Hook to spawn an enemy in blueprint.
+	 * \brief Hook to spawn an enemy in blueprint. Used unless FindEnemySpawnTransform places a pooled enemy, so blueprint placement is kept by default. Call AcquireEnemy to reuse pooled enemies.
 	 */
 	UFUNCTION(BlueprintImplementableEvent, Category = "GameMode")
 	void SpawnNewEnemy();
 
+	/**
+	 * \brief Find where the next pooled enemy is placed natively, instead of by SpawnNewEnemy. By default, only used if bPlacePooledEnemiesNearPlayers is set.
+	 * \param SpawnTransformOut Where the enemy should be placed.
+	 * \return true if a spawn location was found.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "GameMode")
+	bool FindEnemySpawnTransform(FTransform& SpawnTransformOut);
+
+	/**
+	 * \brief Take an enemy from the enemy pool, or spawn one if the pool is empty. Used to spawn the pooled enemy class, and can be used by SpawnNewEnemy instead of spawning other enemies.
+	 * \param EnemyClass The class of enemy to acquire.
+	 * \param SpawnTransform Where the enemy should be placed.
+	 * \return The enemy, revived with full health and ammo.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GameMode")
+	ANexusAICharacter* AcquireEnemy(TSubclassOf<ANexusAICharacter> EnemyClass, const FTransform& SpawnTransform);
+
 	/**
 	 * \brief Start spawning enemies.
 	 */
@@ -93,6 +118,24 @@ protected:
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GameMode")
 	int MaxEnemiesOnMap = 8;
+
+	/**
+	 * \brief Enemy class spawned into the enemy pool before the first wave, so enemies are not spawned during a wave. (None = no enemies spawned up front)
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GameMode")
+	TSubclassOf<ANexusAICharacter> PooledEnemyClass;
+
+	/**
+	 * \brief Should pooled enemies be placed at a random navigable point near a random living player, instead of by SpawnNewEnemy.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GameMode")
+	bool bPlacePooledEnemiesNearPlayers = false;
+
+	/**
+	 * \brief The distance from a player within which pooled enemies are placed, when bPlacePooledEnemiesNearPlayers is set.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GameMode", meta = (ClampMin = 0))
+	float EnemySpawnRadius = 3000.0f;
 	
 	/**
 	 * \brief The duration of the delay before the next wave starts.
@@ -7,6 +7,9 @@
 #include "NexusPlayerCharacter.generated.h"
 
 class UNexusHUDUserWidget;
+class UCameraComponent;
+class USpringArmComponent;
+class USceneCaptureComponent2D;
 
 UCLASS()
 class NEXUS_API ANexusPlayerCharacter : public ANexusCharacter
@@ -14,19 +17,94 @@ class NEXUS_API ANexusPlayerCharacter : public ANexusCharacter
 	GENERATED_BODY()
 
 public:
+	// Sets default values for this character's properties
+	ANexusPlayerCharacter();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Called to bind functionality to input
+	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+
+	/**
+	 * \brief Return the player's view location.
+	 * \return Camera location
+	 */
+	virtual FVector GetPawnViewLocation() const override;
 
 	/**
 	 * \brief Make the character swap the currently equipped weapon.
 	 */
 	virtual void SwapWeapon() override;
 
+	/**
+	 * \brief Start capturing the face cam at the face cam capture rate. Only the locally controlled player has a face cam.
+	 */
+	void StartFaceCam();
+
+	/**
+	 * \brief Stop capturing the face cam.
+	 */
+	void StopFaceCam();
+
 protected:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the character is removed from the level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void HealthChanged(UNexusHealthComponent* HealthComponent, float Health, float HealthDelta, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser) override;
 
+	/**
+	 * \brief Check if the face cam is currently on screen, so needs capturing. The face cam is shown on the HUD.
+	 * \return true if the HUD is on screen.
+	 */
+	bool IsFaceCamVisible() const;
+
+	/**
+	 * \brief Third person camera component
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UCameraComponent* CameraComponent;
+
+	/**
+	 * \brief Component used to mount the camera.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USpringArmComponent* SpringArmComponent;
+
+	/**
+	 * \brief Component used to capture character to render in UI. Only activated for the locally controlled player, while the face cam is capturing.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USceneCaptureComponent2D* CharacterCaptureComponent;
+
+	/**
+	 * \brief The number of times per second the face cam is captured.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player", meta = (ClampMin = 1, ClampMax = 60))
+	float FaceCamCaptureRate = 10.0f;
+
+	/**
+	 * \brief Name of the socket used to attach facecam to character's head.
+	 */
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	FName FaceCamSocketName = "head";
+
+	/**
+	 * \brief Field of view value for aiming down sights.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player")
+	float AimingFOV = 65.0f;
+
+	/**
+	 * \brief Speed of the aim down sight interpolation.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player", meta = (ClampMin = 0.1, ClampMax = 100))
+	float ADSInterpolationSpeed = 20.0f;
+
 	/**
 	 * \brief Camera shake triggered when player is hit.
 	 */
@@ -65,9 +143,80 @@ private:
 	 * \brief Play the camera shake effect for when the player is hit.
 	 */
 	void PlayFlinchCameraShake();
+
+	/**
+	 * \brief Set the camera field of view to set aim zoom.
+	 * \param DeltaTime Time since last update.
+	 */
+	void SetAimDownSight(float DeltaTime);
+
+	/**
+	 * \brief Capture the face cam, if it is on screen.
+	 */
+	void CaptureFaceCam() const;
 	
 	/**
 	 * \brief Handle used to manage the timer that delays player input and the HUD.
 	 */
 	FTimerHandle TimerHandle_PlayerStart;
+
+	/**
+	 * \brief Handle used to manage the face cam capture timer.
+	 */
+	FTimerHandle TimerHandle_FaceCamCapture;
+
+	/**
+	 * \brief Default FOV value for the camera, cached on begin play.
+	 */
+	float DefaultFOV;
+
+	/**
+	 * \brief Name used for move forward input binding.
+	 */
+	const FName MoveForwardBindingName = "MoveForward";
+
+	/**
+	 * \brief Name used for move right input binding.
+	 */
+	const FName MoveRightBindingName = "MoveRight";
+
+	/**
+	 * \brief Name used for look up input binding.
+	 */
+	const FName LookUpBindingName = "LookUp";
+
+	/**
+	 * \brief Name used for turn input binding.
+	 */
+	const FName TurnBindingName = "Turn";
+
+	/**
+	 * \brief Name used for crouch input binding.
+	 */
+	const FName CrouchBindingName = "Crouch";
+
+	/**
+	 * \brief Name used for jump input binding.
+	 */
+	const FName JumpBindingName = "Jump";
+
+	/**
+	 * \brief Name used for aiming input binding.
+	 */
+	const FName AimingBindingName = "AimDownSight";
+
+	/**
+	 * \brief Name used for shooting input binding.
+	 */
+	const FName ShootBindingName = "Fire";
+
+	/**
+	 * \brief Name used for reload input binding.
+	 */
+	const FName ReloadBindingName = "Reload";
+
+	/**
+	 * \brief Name used for swap weapon input binding.
+	 */
+	const FName SwapWeaponBindingName = "SwapWeapon";
 };
@@ -8,25 +8,203 @@
 
 class ANexusCharacter;
 class USkeletalMeshComponent;
+class UStaticMesh;
+class UMaterialInterface;
+struct FHitScanShotPolicy;
+struct FPelletShotPolicy;
+struct FNexusWeaponBenchmark;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnWeaponAmmoUpdatedSignature, ANexusWeapon*, Weapon, int32, NewAmmoInClip, int32, NewAmmoInReserve);
 
+/**
+ * \brief Compact record of the shots fired by a weapon. Replicated so that clients can play the fire cosmetics locally.
+ */
 USTRUCT()
-struct FHitScanInfo
+struct FWeaponFireEvent
 {
 	GENERATED_USTRUCT_BODY()
 
 	/**
-	 * \brief The type of surface that was hit.
+	 * \brief Incremented every time the weapon fires. Wraps around, only a change in value is meaningful.
+	 */
+	UPROPERTY()
+	uint8 FireCount;
+
+	/**
+	 * \brief Was the owner aiming down sights for the latest shot. Used to select the fire animation.
+	 */
+	UPROPERTY()
+	uint8 bAimingDownSights : 1;
+
+	/**
+	 * \brief Sequence number of the latest shot. Clients derive the spread of each shot from it, so they can reproduce the shot's traces.
+	 */
+	UPROPERTY()
+	uint16 ShotSequence;
+
+	FWeaponFireEvent()
+		: FireCount(0)
+		, bAimingDownSights(false)
+		, ShotSequence(0)
+	{
+	}
+};
+
+/**
+ * \brief Types of ammo change the owning client predicts.
+ */
+enum class EAmmoEventType : uint8
+{
+	Shot,
+	Reload,
+	Restore,
+};
+
+/**
+ * \brief An ammo change applied by the owning client that the server has not acknowledged yet.
+ */
+struct FPredictedAmmoEvent
+{
+	/**
+	 * \brief Sequence number sent to the server with the event.
+	 */
+	uint16 EventId;
+
+	/**
+	 * \brief The type of ammo change.
+	 */
+	EAmmoEventType EventType;
+};
+
+/**
+ * \brief The server's ammo state, and the last predicted ammo event from the owning client that it includes.
+ */
+USTRUCT()
+struct FWeaponAmmoAck
+{
+	GENERATED_USTRUCT_BODY()
+
+	/**
+	 * \brief The last owning client ammo event processed by the server.
+	 */
+	UPROPERTY()
+	uint16 LastEventId = 0;
+
+	/**
+	 * \brief The amount of ammo in the clip on the server.
 	 */
 	UPROPERTY()
-	TEnumAsByte<EPhysicalSurface> HitSurfaceType;
+	int32 AmmoInClip = 0;
 
 	/**
-	 * \brief End location for hit scan trace.
+	 * \brief The total amount of ammo on the server.
 	 */
 	UPROPERTY()
-	FVector_NetQuantize TraceTargetLocation;
+	int32 TotalAmmo = 0;
+};
+
+/**
+ * \brief Hits from a single shot on one actor and surface type.
+ */
+struct FWeaponHitGroup
+{
+	/**
+	 * \brief The actor that was hit.
+	 */
+	TWeakObjectPtr<AActor> HitActor;
+
+	/**
+	 * \brief The type of surface that was hit.
+	 */
+	EPhysicalSurface SurfaceType;
+
+	/**
+	 * \brief The number of traces in the shot that hit this actor and surface.
+	 */
+	int32 HitCount;
+
+	/**
+	 * \brief The combined damage of every hit in the group, with the surface multiplier applied.
+	 */
+	float Damage;
+
+	/**
+	 * \brief The first hit in the group. Used as the hit info for the damage event and the impact cue location.
+	 */
+	FHitResult HitResult;
+
+	/**
+	 * \brief Direction of the first hit in the group.
+	 */
+	FVector ShotDirection;
+};
+
+/**
+ * \brief Every hit from a single shot, grouped per actor and surface type so that damage and the impact cue are applied once.
+ */
+struct FWeaponShotHits
+{
+	/**
+	 * \brief Hit groups, in the order they were first hit.
+	 */
+	TArray<FWeaponHitGroup, TInlineAllocator<4>> HitGroups;
+
+	/**
+	 * \brief Add a hit to the group for its actor and surface type.
+	 * \param HitResult The blocking hit.
+	 * \param SurfaceType The type of surface that was hit.
+	 * \param ShotDirection Direction of the shot.
+	 * \param Damage Damage dealt by the hit.
+	 */
+	void AddHit(const FHitResult& HitResult, EPhysicalSurface SurfaceType, const FVector& ShotDirection, float Damage)
+	{
+		AActor* HitActor = HitResult.GetActor();
+
+		FWeaponHitGroup* HitGroup = HitGroups.FindByPredicate([HitActor, SurfaceType](const FWeaponHitGroup& Group)
+		{
+			return Group.HitActor.Get() == HitActor && Group.SurfaceType == SurfaceType;
+		});
+
+		if (!HitGroup)
+		{
+			HitGroup = &HitGroups.AddDefaulted_GetRef();
+			HitGroup->HitActor = HitActor;
+			HitGroup->SurfaceType = SurfaceType;
+			HitGroup->HitCount = 0;
+			HitGroup->Damage = 0.0f;
+			HitGroup->HitResult = HitResult;
+			HitGroup->ShotDirection = ShotDirection;
+		}
+
+		++HitGroup->HitCount;
+		HitGroup->Damage += Damage;
+	}
+};
+
+/**
+ * \brief A shot fired by the automatic fire scheduler, at a time between the previous frame and the current frame.
+ */
+struct FWeaponScheduledShot
+{
+	/**
+	 * \brief World time the shot was scheduled for.
+	 */
+	float ShotTime;
+
+	/**
+	 * \brief The owner's eye location, interpolated to the shot time.
+	 */
+	FVector ViewLocation;
+
+	/**
+	 * \brief The owner's eye rotation, interpolated to the shot time.
+	 */
+	FRotator ViewRotation;
+
+	/**
+	 * \brief Offset from the owner's current eye location to the interpolated eye location. Applied to the muzzle.
+	 */
+	FVector MuzzleOffset;
 };
 
 /**
@@ -65,6 +243,10 @@ UCLASS()
 class NEXUS_API ANexusWeapon : public AActor
 {
 	GENERATED_BODY()
+
+	friend struct FHitScanShotPolicy;
+	friend struct FPelletShotPolicy;
+	friend struct FNexusWeaponBenchmark;
 	
 public:	
 	// Sets default values for this actor's properties
@@ -188,29 +370,154 @@ protected:
 	bool HasAmmoInClip() const;
 
 	/**
-	 * \brief Fire a line trace to apply damage and play effects on anything hit.
-	 * \param WeaponOwner The owner that fired the weapon. Used to apply damage.
+	 * \brief Fire a line trace to gather damage and play effects on anything hit. Damage is applied with ApplyShotHits.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 * \param ShotHits Hits from the current shot. Any hit is added to it.
 	 * \param BulletTracerTargetOut Location of the hit, or the end of the line trace.
 	 * \param SurfaceTypeOut The type of surface that was hit. Used to determine damage multipliers and effects to be played.
 	 */
-	void LineTraceForDamageAndImpactEffects(AActor* WeaponOwner, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut);
-	
+	void LineTraceForDamageAndImpactEffects(AActor* WeaponOwner, FWeaponShotHits& ShotHits, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut);
+
+	/**
+	 * \brief Calculate the start and end locations of a weapon trace, with bullet spread applied.
+	 * \param WeaponOwner The owner that fired the weapon. Used to get the eye view point.
+	 * \param TraceStartOut Start location of the trace.
+	 * \param TraceEndOut End location of the trace.
+	 * \param ShotDirectionOut Direction of the shot, after spread has been applied.
+	 */
+	void CalculateShotTrace(AActor* WeaponOwner, FVector& TraceStartOut, FVector& TraceEndOut, FVector& ShotDirectionOut) const;
+
+	/**
+	 * \brief Get the collision query parameters used by weapon traces.
+	 * \param WeaponOwner The owner that fired the weapon. Ignored by the trace.
+	 * \return Query parameters for the weapon trace channel.
+	 */
+	FCollisionQueryParams GetWeaponTraceQueryParams(AActor* WeaponOwner) const;
+
+	/**
+	 * \brief Add a blocking weapon trace hit to the shot, and play its impact particle effect.
+	 * \param ShotHits Hits from the current shot.
+	 * \param WeaponHitResult The blocking hit returned by the trace.
+	 * \param ShotDirection Direction of the shot.
+	 * \param BulletTracerTargetOut Location of the hit.
+	 * \param SurfaceTypeOut The type of surface that was hit.
+	 */
+	void ResolveWeaponTraceHit(FWeaponShotHits& ShotHits, const FHitResult& WeaponHitResult, const FVector& ShotDirection, FVector& BulletTracerTargetOut, EPhysicalSurface& SurfaceTypeOut);
+
+	/**
+	 * \brief Apply one combined damage event to each actor hit by the shot, and play a single impact cue for the shot.
+	 * \param WeaponOwner The owner that fired the weapon. Used to apply damage.
+	 * \param ShotHits Hits from the shot.
+	 */
+	void ApplyShotHits(AActor* WeaponOwner, const FWeaponShotHits& ShotHits);
+
 	/**
 	 * \brief Shoot the weapon.
 	 */
 	virtual void Fire() { }
 
+	/**
+	 * \brief Start shooting the weapon with a trigger policy. Defined in NexusWeaponFirePolicies.h.
+	 */
+	template<class TTriggerPolicy>
+	void StartFiringWithPolicy();
+
+	/**
+	 * \brief Shoot the weapon with a trigger policy and shot policy. Defined in NexusWeaponFirePolicies.h.
+	 * TWeapon is the type the shot policy is given this weapon as, for shot policies that call functions of a derived weapon.
+	 */
+	template<class TTriggerPolicy, class TShotPolicy, class TWeapon = ANexusWeapon>
+	void FireWithPolicies();
+
+	/**
+	 * \brief Fire hit scan traces for a shot, apply their damage and play the fired effects.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 * \param NumTraces The number of traces in the shot.
+	 */
+	void FireHitScanTraces(AActor* WeaponOwner, int32 NumTraces);
+
+	/**
+	 * \brief Start automatic fire. Shots are fired from Tick at their exact scheduled times.
+	 */
+	void StartScheduledFire();
+
+	/**
+	 * \brief Fire every automatic shot owed since the previous frame, with the owner's view point interpolated to each shot time.
+	 * \param DeltaTime Time elapsed since the previous frame.
+	 */
+	void FireScheduledShots(float DeltaTime);
+
+	/**
+	 * \brief Get the view point a shot is fired from. Scheduled shots use the view point interpolated to the shot time.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 * \param ViewLocationOut Eye location of the shot.
+	 * \param ViewRotationOut Eye rotation of the shot.
+	 */
+	void GetShotViewPoint(AActor* WeaponOwner, FVector& ViewLocationOut, FRotator& ViewRotationOut) const;
+
+	/**
+	 * \brief Get the muzzle location of the current shot.
+	 * \return Location of the muzzle socket, offset to the shot time for scheduled shots.
+	 */
+	FVector GetShotMuzzleLocation() const;
+
+	/**
+	 * \brief Get the world time of the current shot.
+	 * \return The scheduled shot time, or the current world time if the shot was not scheduled.
+	 */
+	float GetShotTime() const;
+
 	/**
 	 * \brief Shoot the weapon on the server.
+	 * \param ClientFireTime The server world time, as estimated by the client, when the client fired. Used for lag compensation.
+	 * \param AmmoEventId The client's predicted ammo event for the shot.
+	 * \param ShotSequence Sequence number of the shot. Seeds the shot's spread, so the server traces the same directions as the client.
 	 */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerFire();
+	void ServerFire(float ClientFireTime, uint16 AmmoEventId, uint16 ShotSequence);
+
+	/**
+	 * \brief Get the current server world time. On clients this is the client's estimate of the server time.
+	 * \return Server world time in seconds.
+	 */
+	float GetServerWorldTime() const;
 
 	/**
-	 * \brief Replicate weapon hit effects.
+	 * \brief Replicate weapon fire cosmetics, and reproduce the traces of each new shot to play its tracer and impact effects.
 	 */
 	UFUNCTION()
-	void OnRep_HitScanInfo();
+	void OnRep_FireEvent();
+
+	/**
+	 * \brief Record a shot in the replicated fire event. Only has effect on the server authority.
+	 * \param ShotSequence Sequence number of the shot.
+	 */
+	void RecordFireEvent(uint16 ShotSequence);
+
+	/**
+	 * \brief Seed the spread stream for a shot. Every machine that seeds the same shot sequence derives the same shot directions.
+	 * \param ShotSequence Sequence number of the shot.
+	 */
+	void SeedShotSpread(uint16 ShotSequence);
+
+	/**
+	 * \brief Get the number of hit scan traces fired per shot. Used by other clients to reproduce shots. (0 = not a hit scan weapon)
+	 * \return The number of traces per shot.
+	 */
+	virtual int32 GetHitScanTracesPerShot() const { return 0; }
+
+	/**
+	 * \brief Reproduce the traces of a shot fired on another machine, and play its tracer and impact effects. Does not apply damage.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 * \param NumTraces The number of traces in the shot.
+	 */
+	void PlaySimulatedHitScanTraces(AActor* WeaponOwner, int32 NumTraces);
+
+	/**
+	 * \brief Play the sound effect and animation for a shot locally.
+	 * \param bAimingDownSights Was the owner aiming down sights when the shot was fired.
+	 */
+	void PlayFireCosmetics(bool bAimingDownSights) const;
 
 	/**
 	 * \brief Check if the weapon can be reloaded.
@@ -225,15 +532,48 @@ protected:
 
 	/**
 	 * \brief Reload the weapon on the server.
+	 * \param AmmoEventId The client's predicted ammo event for the reload.
 	 */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerReload();
+	void ServerReload(uint16 AmmoEventId);
 
 	/**
 	 * \brief Restore weapon ammo on the server.
+	 * \param AmmoAmount
+	 * \param AmmoEventId The client's predicted ammo event for the restore.
 	 */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerRestoreAmmo(int32 AmmoAmount);
+	void ServerRestoreAmmo(int32 AmmoAmount, uint16 AmmoEventId);
+
+	/**
+	 * \brief Rebase the owning client's ammo on the server state, and reapply the predicted events the server has not processed yet.
+	 */
+	UFUNCTION()
+	void OnRep_AmmoAck();
+
+	/**
+	 * \brief Record an ammo change predicted by the owning client.
+	 * \param EventType The type of ammo change.
+	 * \return Sequence number to send to the server with the event.
+	 */
+	uint16 PredictAmmoEvent(EAmmoEventType EventType);
+
+	/**
+	 * \brief Mark an owning client ammo event as processed, and send the resulting ammo state back. Only has effect on the server authority.
+	 * \param AmmoEventId The client's predicted ammo event.
+	 */
+	void AcknowledgeAmmoEvent(uint16 AmmoEventId);
+
+	/**
+	 * \brief Copy the current ammo state into the replicated acknowledgement. Only has effect on the server authority.
+	 */
+	void UpdateAmmoAck();
+
+	/**
+	 * \brief Apply an ammo change to the clip and total ammo.
+	 * \param EventType The type of ammo change.
+	 */
+	void ApplyAmmoEvent(EAmmoEventType EventType);
 	
 	/**
 	 * \brief Call the server to play an animation montage.
@@ -259,17 +599,6 @@ protected:
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastPlaySFX(USoundBase* SoundEffect);
 
-	/**
-	 * \brief Call the server to play a sound effect at the given location.
-	 */
-	UFUNCTION(Server, Reliable)
-	void ServerPlaySFXAtLocation(USoundBase* SoundEffect, FVector Location);
-
-	/**
-	 * \brief Play the sound effect on the server and all clients.
-	 */
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastPlaySFXAtLocation(USoundBase* SoundEffect, FVector Location);
 	
 	/**
 	 * \brief The visible mesh of the weapon.
@@ -307,6 +636,12 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	float WeaponRateOfFire = 60.0f;
 
+	/**
+	 * \brief The maximum number of automatic shots fired in one frame. Shots owed beyond this (e.g. after a long hitch) are dropped.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", meta = (ClampMin = 1))
+	int32 MaxScheduledShotsPerFrame = 8;
+
 	/**
 	 * \brief The bullet spread angle of the weapon (in degrees).
 	 */
@@ -328,7 +663,7 @@ protected:
 	/**
 	 * \brief The total amount of currently available ammo.
 	 */
-	UPROPERTY(Transient, Replicated, BlueprintReadOnly, Category = "Weapon")
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Weapon")
 	int32 CurrentTotalAmmo;
 
 	/**
@@ -340,8 +675,29 @@ protected:
 	/**
 	 * \brief The amount of ammo currently loaded in the clip.
 	 */
-	UPROPERTY(Transient, Replicated, BlueprintReadOnly, Category = "Weapon")
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Weapon")
 	int32 CurrentAmmoInClip;
+
+	/**
+	 * \brief Ammo state for replication to the owner. Replaces replicating the ammo counts, which would overwrite the owner's predicted ammo.
+	 */
+	UPROPERTY(ReplicatedUsing=OnRep_AmmoAck)
+	FWeaponAmmoAck AmmoAck;
+
+	/**
+	 * \brief Ammo events applied by the owning client that the server has not acknowledged, oldest first.
+	 */
+	TArray<FPredictedAmmoEvent, TInlineAllocator<16>> PendingAmmoEvents;
+
+	/**
+	 * \brief The maximum number of unacknowledged ammo events kept. The oldest are dropped, e.g. if the server stops acknowledging.
+	 */
+	static constexpr int32 MaxPendingAmmoEvents = 64;
+
+	/**
+	 * \brief Sequence number for the owning client's next predicted ammo event.
+	 */
+	uint16 NextAmmoEventId = 1;
 	
 	/**
 	 * \brief The maximum amount of ammo that can be loaded into the clip.
@@ -391,6 +747,18 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
 	UParticleSystem* TracerVFX;
 
+	/**
+	 * \brief Mesh drawn by the batched tracer renderer when the weapon is fired. Points along X. Falls back to TracerVFX if not set.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	UStaticMesh* TracerMesh;
+
+	/**
+	 * \brief Material drawn on the tracer mesh. Uses the mesh material if not set.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	UMaterialInterface* TracerMaterial;
+
 	/**
 	 * \brief Name of the bullet tracer effect's target vector parameter.
 	 */
@@ -473,10 +841,46 @@ protected:
 	FName WeaponName;
 
 	/**
-	 * \brief Hit scan information for replication.
+	 * \brief Seed for the weapon's spread. Chosen by the server authority, and combined with the shot sequence to seed each shot.
+	 */
+	UPROPERTY(Replicated)
+	int32 SpreadSeed;
+
+	/**
+	 * \brief Sequence number of the next shot.
 	 */
-	UPROPERTY(ReplicatedUsing=OnRep_HitScanInfo)
-	FHitScanInfo HitScanInfo;
+	uint16 NextShotSequence = 0;
+
+	/**
+	 * \brief The furthest a client's shot sequence may be ahead of the server's. The server keeps its own sequence for shots further ahead, or behind.
+	 */
+	static constexpr uint16 MaxShotSequenceSkip = 8;
+
+	/**
+	 * \brief Random stream used for the spread of the current shot.
+	 */
+	FRandomStream ShotSpreadStream;
+
+	/**
+	 * \brief The fire count of the last replicated shot that was reproduced.
+	 */
+	uint8 LastSimulatedFireCount = 0;
+
+	/**
+	 * \brief Has a fire event been received since the weapon became relevant.
+	 */
+	bool bFireEventReceived = false;
+
+	/**
+	 * \brief The maximum number of shots reproduced per fire event update. Older shots between net updates are skipped.
+	 */
+	static constexpr int32 MaxSimulatedShotsPerUpdate = 8;
+
+	/**
+	 * \brief Fire event for replication. Replaces per shot cosmetic RPCs.
+	 */
+	UPROPERTY(ReplicatedUsing=OnRep_FireEvent)
+	FWeaponFireEvent FireEvent;
 
 	/**
 	 * \brief The character that currently owns this weapon.
@@ -503,7 +907,14 @@ protected:
 	 * \param Target The location of the impact
 	 */
 	void PlayImpactEffect(EPhysicalSurface SurfaceType, FVector Target);
-	
+
+	/**
+	 * \brief Spawn sound effect for weapon impact.
+	 * \param SurfaceType The type of surface that was hit.
+	 * \param Target The location of the impact
+	 */
+	void PlayImpactSFX(EPhysicalSurface SurfaceType, FVector Target);
+
 	/**
 	 * \brief Play all effects for when the weapon is fired.
 	 * \param Target Weapon hit location.
@@ -527,9 +938,9 @@ protected:
 	void PlayCameraShake() const;
 
 	/**
-	 * \brief Spawn sound effect for weapon fired.
+	 * \brief Spawn sound effect for weapon fired. Played locally, other clients play it from the replicated fire event.
 	 */
-	void PlayFiredSFX();
+	void PlayFiredSFX() const;
 
 	/**
 	 * \brief Spawn sound effect for weapon fired with no ammo.
@@ -537,9 +948,10 @@ protected:
 	void PlayDryFiredSFX();
 
 	/**
-	 * \brief Play the fired animation on the owning player.
+	 * \brief Play the fired animation on the owning player. Played locally, other clients play it from the replicated fire event.
+	 * \param bAimingDownSights Was the owner aiming down sights when the shot was fired.
 	 */
-	void PlayFiredAnimation();
+	void PlayFiredAnimation(bool bAimingDownSights) const;
 
 	/**
 	 * \brief Get the damage multiplier for the surface type that was hit.
@@ -554,9 +966,34 @@ protected:
 	void DepleteAmmo();
 
 	/**
-	 * \brief Handle used to manage the weapon fire delay timer.
+	 * \brief Is automatic fire scheduled. Shots are fired from Tick, rather than a looping timer, so none are dropped or bunched when the frame time is longer than the fire delay.
+	 */
+	bool bScheduledFireActive = false;
+
+	/**
+	 * \brief World time of the next scheduled automatic shot.
+	 */
+	float NextScheduledShotTime = 0.0f;
+
+	/**
+	 * \brief The owner's eye location at the end of the previous frame. Start point for interpolating scheduled shots.
 	 */
-	FTimerHandle TimerHandle_WeaponFireDelay;
+	FVector PreviousViewLocation;
+
+	/**
+	 * \brief The owner's eye rotation at the end of the previous frame.
+	 */
+	FQuat PreviousViewRotation;
+
+	/**
+	 * \brief Is the previous view point valid. Cleared when automatic fire stops.
+	 */
+	bool bHasPreviousViewPoint = false;
+
+	/**
+	 * \brief The scheduled shot being fired. Null outside of FireScheduledShots.
+	 */
+	const FWeaponScheduledShot* CurrentScheduledShot = nullptr;
 
 	/**
 	 * \brief Handle used to manage the weapon reload delay timer.
@@ -573,6 +1010,17 @@ protected:
 	 */
 	float WeaponFireDelayTime;
 
+	/**
+	 * \brief Shots left to fire for the current trigger pull. Only used by trigger policies with a fixed number of shots.
+	 */
+	int32 TriggerShotsRemaining = 0;
+
+	/**
+	 * \brief Set while the server runs a client's shot with the world rewound to the client's fire time.
+	 *	@note Traces that resolve after the shot (async traces) would not see the rewound world, so must run synchronously.
+	 */
+	bool bLagCompensatedShot = false;
+
 	/**
 	 * \brief Name of the weapon IK socket.
 	 */
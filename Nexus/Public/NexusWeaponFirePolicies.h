@@ -0,0 +1,154 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NexusWeapon.h"
+#include "NexusCharacter.h"
+
+/**
+ * Fire pipeline policies.
+ *
+ * A weapon's fire behaviour is a trigger policy combined with a shot policy, chosen at compile time:
+ *
+ *		void ABurstRifle::StartFiring() { StartFiringWithPolicy<TBurstTriggerPolicy<3>>(); }
+ *		void ABurstRifle::Fire() { FireWithPolicies<TBurstTriggerPolicy<3>, FHitScanShotPolicy>(); }
+ *
+ * The shared fire steps (ammo, server fire, cosmetics, fire event) are written once in ANexusWeapon::FireWithPolicies.
+ * The policy calls are resolved at compile time and inlined into each weapon's Fire, so a shot has no fire mode checks.
+ * Fire itself is still virtual, as the fire scheduler and ServerFire call it through the base weapon.
+ */
+
+/**
+ * \brief Keep firing while the trigger is held.
+ */
+struct FAutomaticTriggerPolicy
+{
+	/**
+	 * \brief The number of shots fired per trigger pull. (0 = until the trigger is released)
+	 */
+	static constexpr int32 ShotsPerTrigger = 0;
+};
+
+/**
+ * \brief Fire a single shot per trigger pull.
+ */
+struct FSemiAutomaticTriggerPolicy
+{
+	/**
+	 * \brief The number of shots fired per trigger pull.
+	 */
+	static constexpr int32 ShotsPerTrigger = 1;
+};
+
+/**
+ * \brief Fire a fixed number of shots per trigger pull. Releasing the trigger ends the burst early.
+ */
+template<int32 InShotsPerBurst>
+struct TBurstTriggerPolicy
+{
+	static_assert(1 < InShotsPerBurst, "A burst must fire more than one shot.");
+
+	/**
+	 * \brief The number of shots fired per trigger pull.
+	 */
+	static constexpr int32 ShotsPerTrigger = InShotsPerBurst;
+};
+
+/**
+ * \brief Fire a single hit scan trace per shot.
+ */
+struct FHitScanShotPolicy
+{
+	template<class TWeapon>
+	static void Shoot(TWeapon& Weapon, AActor* WeaponOwner)
+	{
+		Weapon.FireHitScanTraces(WeaponOwner, 1);
+	}
+};
+
+/**
+ * \brief Fire several hit scan pellets per shot. The weapon must implement FirePellets.
+ */
+struct FPelletShotPolicy
+{
+	template<class TWeapon>
+	static void Shoot(TWeapon& Weapon, AActor* WeaponOwner)
+	{
+		Weapon.FirePellets(WeaponOwner);
+	}
+};
+
+template<class TTriggerPolicy>
+void ANexusWeapon::StartFiringWithPolicy()
+{
+	TriggerShotsRemaining = TTriggerPolicy::ShotsPerTrigger;
+
+	if (1 == TTriggerPolicy::ShotsPerTrigger)
+	{
+		// Weapon should fire once, if the time elapsed since the last shot is greater than the fire delay.
+		if (GetWorld()->GetTimeSeconds() >= LastFireTime + WeaponFireDelayTime)
+		{
+			Fire();
+		}
+		return;
+	}
+
+	// Repeating triggers fire from the tick scheduler, so the delivered rate of fire does not depend on the frame rate.
+	StartScheduledFire();
+}
+
+template<class TTriggerPolicy, class TShotPolicy, class TWeapon>
+void ANexusWeapon::FireWithPolicies()
+{
+	static_assert(TIsDerivedFrom<TWeapon, ANexusWeapon>::IsDerived, "The shot policy's weapon must be a weapon.");
+
+	AActor* WeaponOwner = GetOwner();
+
+	if (!WeaponOwner || !CanFireWeapon())
+	{
+		return;
+	}
+
+	if (!HasAmmoInClip())
+	{
+		// There is no ammo loaded in the clip, so the weapon should dry fire.
+		PlayDryFiredSFX();
+		StopFiring();
+		return;
+	}
+
+	SetWeaponState(EWeaponState::Firing);
+
+	// The shot's spread is derived from its sequence number.
+	const uint16 ShotSequence = NextShotSequence++;
+	SeedShotSpread(ShotSequence);
+
+	// Fire should only be called via the server authority. The owning client predicts the ammo used by the shot.
+	if (ROLE_Authority > GetLocalRole())
+	{
+		// Scheduled shots can be fired part way between frames, so the server rewinds to the shot's exact time.
+		const float ShotAge = GetWorld()->GetTimeSeconds() - GetShotTime();
+
+		ServerFire(FMath::Max(GetServerWorldTime() - ShotAge, 0.0f), PredictAmmoEvent(EAmmoEventType::Shot), ShotSequence);
+	}
+
+	// Use ammo.
+	DepleteAmmo();
+
+	TShotPolicy::Shoot(static_cast<TWeapon&>(*this), WeaponOwner);
+
+	// Play the fire sound and animation locally. Other clients play them from the replicated fire event.
+	PlayFireCosmetics(OwningCharacter && OwningCharacter->IsAimingDownSights());
+
+	RecordFireEvent(ShotSequence);
+
+	// This needs to be set to prevent the firing rate getting bypassed with rapid firing input.
+	LastFireTime = GetShotTime();
+
+	// Bursts stop once every shot in the burst has been fired.
+	if (0 < TTriggerPolicy::ShotsPerTrigger && 0 >= --TriggerShotsRemaining)
+	{
+		StopFiring();
+	}
+}
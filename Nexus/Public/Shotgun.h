@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "NexusWeapon.h"
+#include "WorldCollision.h"
 #include "Shotgun.generated.h"
 
 /**
@@ -14,6 +15,8 @@ class NEXUS_API AShotgun : public ANexusWeapon
 {
 	GENERATED_BODY()
 
+	friend struct FPelletShotPolicy;
+
 public:
 
 	/**
@@ -23,14 +26,102 @@ public:
 	
 protected:
 
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
 	/**
 	 * \brief Shoot the weapon.
 	 */
 	virtual void Fire() override;
 
+	/**
+	 * \brief Get the number of hit scan traces fired per shot.
+	 * \return The number of pellets per shot.
+	 */
+	virtual int32 GetHitScanTracesPerShot() const override { return NumberOfPelletsInShot; }
+
 	/**
 	 * \brief The number of pellets fired per shot.
 	 */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon", meta = (ClampMin = 1))
 	int NumberOfPelletsInShot = 12;
+
+	/**
+	 * \brief Issue pellet traces asynchronously. Damage and impact effects are resolved when the results arrive on the next frame.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	bool bUseAsyncPelletTraces = true;
+
+private:
+
+	/**
+	 * \brief Fire every pellet in the shot. Used by FPelletShotPolicy.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 */
+	void FirePellets(AActor* WeaponOwner);
+
+	/**
+	 * \brief A shot whose pellet traces have been issued, but not yet resolved.
+	 */
+	struct FPendingPelletShot
+	{
+		/**
+		 * \brief Identifies the shot. Passed to each pellet trace as user data.
+		 */
+		uint32 ShotId;
+
+		/**
+		 * \brief The number of pellet traces still waiting on results.
+		 */
+		int32 PelletsRemaining;
+
+		/**
+		 * \brief Bullet tracer target of the most recently resolved pellet.
+		 */
+		FVector BulletTracerTarget;
+
+		/**
+		 * \brief Surface type hit by the most recently resolved pellet.
+		 */
+		EPhysicalSurface SurfaceType;
+
+		/**
+		 * \brief Pellet hits resolved so far.
+		 */
+		FWeaponShotHits ShotHits;
+	};
+
+	/**
+	 * \brief Issue an async line trace for every pellet in the shot.
+	 * \param WeaponOwner The owner that fired the weapon.
+	 */
+	void FirePelletsAsync(AActor* WeaponOwner);
+
+	/**
+	 * \brief Resolve damage and impact effects for a completed pellet trace.
+	 * \param TraceHandle Handle of the completed trace.
+	 * \param TraceDatum Trace results.
+	 */
+	void OnPelletTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/**
+	 * \brief Apply the shot's damage and play its tracer once every pellet in the shot has resolved. Other clients replay the shot from FireEvent's shot sequence.
+	 * \param PendingShot The completed shot.
+	 */
+	void FinishPelletShot(const FPendingPelletShot& PendingShot);
+
+	/**
+	 * \brief Delegate bound to the pellet trace completion handler.
+	 */
+	FTraceDelegate PelletTraceDelegate;
+
+	/**
+	 * \brief Shots waiting on pellet trace results.
+	 */
+	TArray<FPendingPelletShot, TInlineAllocator<4>> PendingPelletShots;
+
+	/**
+	 * \brief Id assigned to the next shot with async pellet traces.
+	 */
+	uint32 NextPelletShotId = 0;
 };
@@ -0,0 +1,77 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusActorPoolSubsystem.generated.h"
+
+/**
+ * \brief Inactive actors of a single class.
+ */
+USTRUCT()
+struct FNexusActorPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	/**
+	 * \brief Actors waiting to be reused.
+	 */
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+};
+
+/**
+ * \brief Reuses actors that implement INexusPoolableActor, instead of spawning and destroying them.
+ * Replicated actors must only be pooled on the server authority. They stay replicated while pooled, so clients do not open and close channels.
+ */
+UCLASS()
+class NEXUS_API UNexusActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * \brief Take an actor from the pool, or spawn one if the pool is empty.
+	 * \param ActorClass The class of actor to acquire.
+	 * \param SpawnTransform Where the actor should be placed.
+	 * \param Owner The owner of the actor.
+	 * \param Instigator The pawn responsible for the actor.
+	 * \return The active actor, or null if one could not be spawned.
+	 */
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator);
+
+	template<class T>
+	T* AcquireActor(TSubclassOf<T> ActorClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator)
+	{
+		return Cast<T>(AcquireActor(TSubclassOf<AActor>(ActorClass), SpawnTransform, Owner, Instigator));
+	}
+
+	/**
+	 * \brief Return an actor to the pool. Actors that are not poolable are destroyed.
+	 * \param Actor The actor to release.
+	 */
+	void ReleaseActor(AActor* Actor);
+
+	/**
+	 * \brief Spawn actors up front, so acquiring them later does not pay for spawning. The actors are spawned hidden and inactive.
+	 * \param ActorClass The class of actor to spawn.
+	 * \param NumActors The number of free actors the pool should hold.
+	 */
+	void WarmPool(TSubclassOf<AActor> ActorClass, int32 NumActors);
+
+private:
+
+	/**
+	 * \brief Spawn a new actor for a pool.
+	 * \return The spawned actor.
+	 */
+	AActor* SpawnPooledActor(TSubclassOf<AActor> ActorClass, const FTransform& SpawnTransform, AActor* Owner, APawn* Instigator) const;
+
+	/**
+	 * \brief One pool per actor class.
+	 */
+	UPROPERTY()
+	TMap<UClass*, FNexusActorPool> Pools;
+};
@@ -0,0 +1,98 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+#include "NexusCharacterAimSubsystem.generated.h"
+
+class ANexusCharacter;
+
+/**
+ * \brief Smooths the aim angles of every character in one pass, to drive the aim animation offsets.
+ * The angles are kept in parallel arrays, so the interpolation is a tight loop over contiguous floats. Not created on a dedicated server.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusCharacterAimSubsystem : public UNexusTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * \brief Start smoothing a character's aim angles.
+	 * \param Character The character to manage.
+	 */
+	void RegisterCharacter(ANexusCharacter* Character);
+
+	/**
+	 * \brief Stop smoothing a character's aim angles.
+	 * \param Character The character to stop managing.
+	 */
+	void UnregisterCharacter(ANexusCharacter* Character);
+
+protected:
+
+	/**
+	 * \brief Speed the smoothed aim angles move towards the target angles.
+	 */
+	UPROPERTY(Config)
+	float AimInterpolationSpeed = 15.0f;
+
+private:
+
+	/**
+	 * \brief Read the target aim angles of every character.
+	 */
+	void GatherTargetAngles();
+
+	/**
+	 * \brief Move every smoothed angle towards its target.
+	 * \param DeltaTime Time since last update.
+	 */
+	void InterpolateAngles(float DeltaTime);
+
+	/**
+	 * \brief Write the smoothed angles back to every character.
+	 */
+	void ApplySmoothedAngles() const;
+
+	/**
+	 * \brief Remove a character and its angles, by swapping with the last character.
+	 * \param CharacterIndex The index of the character to remove.
+	 */
+	void RemoveCharacterAt(int32 CharacterIndex);
+
+	/**
+	 * \brief Managed characters. Each character's angles are stored at the same index in the angle arrays.
+	 */
+	TArray<TWeakObjectPtr<ANexusCharacter>> Characters;
+
+	/**
+	 * \brief Target aim pitch of each character.
+	 */
+	TArray<float> TargetPitchAngles;
+
+	/**
+	 * \brief Target aim yaw of each character.
+	 */
+	TArray<float> TargetYawAngles;
+
+	/**
+	 * \brief Smoothed aim pitch of each character.
+	 */
+	TArray<float> PitchAngles;
+
+	/**
+	 * \brief Smoothed aim yaw of each character.
+	 */
+	TArray<float> YawAngles;
+};
@@ -0,0 +1,226 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+#include "NexusExplosionSubsystem.generated.h"
+
+class AController;
+class UDamageType;
+
+/**
+ * \brief Damage and impulse applied by a single explosion.
+ */
+struct FNexusExplosion
+{
+	/**
+	 * \brief Centre of the explosion.
+	 */
+	FVector Origin = FVector::ZeroVector;
+
+	/**
+	 * \brief The amount of damage dealt to actors within the radius.
+	 */
+	float BaseDamage = 0.0f;
+
+	/**
+	 * \brief The distance within which damage and impulse are applied.
+	 */
+	float Radius = 0.0f;
+
+	/**
+	 * \brief The type of damage that the explosion inflicts.
+	 */
+	TSubclassOf<UDamageType> DamageType;
+
+	/**
+	 * \brief The actor that exploded. It is not pushed by its own impulse.
+	 */
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	/**
+	 * \brief The controller responsible for the explosion.
+	 */
+	TWeakObjectPtr<AController> InstigatedBy;
+
+	/**
+	 * \brief Magnitude of the radial impulse. (0 = no impulse)
+	 */
+	float ImpulseStrength = 0.0f;
+
+	/**
+	 * \brief Should the impulse ignore mass, and change velocity directly.
+	 */
+	bool bImpulseVelChange = true;
+
+	/**
+	 * \brief Called once the explosion's damage has been applied. Damage waits for the occlusion traces, so is applied after the explosion is queued.
+	 */
+	FSimpleDelegate OnApplied;
+};
+
+/**
+ * \brief Occlusion trace from an explosion to a component within its radius.
+ */
+struct FExplosionOcclusionTrace
+{
+	/**
+	 * \brief Handle of the async trace.
+	 */
+	FTraceHandle TraceHandle;
+
+	/**
+	 * \brief The actor that owns the component.
+	 */
+	TWeakObjectPtr<AActor> Actor;
+
+	/**
+	 * \brief The component being traced to.
+	 */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/**
+	 * \brief The end of the trace, at the centre of the component's bounds.
+	 */
+	FVector TraceEnd = FVector::ZeroVector;
+
+	/**
+	 * \brief Hit passed to the damage event, if nothing blocks the explosion from reaching the component.
+	 */
+	FHitResult ExposedHit;
+
+	/**
+	 * \brief Nothing blocks the explosion from reaching the component.
+	 */
+	bool bExposed = false;
+};
+
+/**
+ * \brief An explosion waiting for its occlusion traces before its damage is applied.
+ */
+struct FPendingExplosionDamage
+{
+	/**
+	 * \brief The explosion being applied.
+	 */
+	FNexusExplosion Explosion;
+
+	/**
+	 * \brief Identifies the explosion's traces.
+	 */
+	uint32 ExplosionId = 0;
+
+	/**
+	 * \brief One trace per component that can be damaged, grouped by actor.
+	 */
+	TArray<FExplosionOcclusionTrace> OcclusionTraces;
+
+	/**
+	 * \brief The number of traces that have not completed.
+	 */
+	int32 TracesRemaining = 0;
+};
+
+/**
+ * \brief Applies explosion damage and impulse from a single overlap query per explosion.
+ * The impulse is applied straight away. The occlusion traces for damage are batched with the frame's async traces, so damage is applied when their results arrive at the start of the next frame.
+ * Explosions triggered by another explosion (chain reactions) are queued, and the queue is drained under a per frame budget.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusExplosionSubsystem : public UNexusTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * \brief Apply an explosion. It is applied immediately, unless it was triggered by another explosion or the frame budget has been used.
+	 * \param Explosion The explosion to apply.
+	 */
+	void QueueExplosion(const FNexusExplosion& Explosion);
+
+protected:
+
+	/**
+	 * \brief The maximum number of explosions applied per frame. Further explosions wait for the next frame.
+	 */
+	UPROPERTY(Config)
+	int32 MaxExplosionsPerFrame = 4;
+
+	/**
+	 * \brief Channel used to check that an actor is not behind cover from the explosion.
+	 */
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> DamagePreventionChannel = ECC_Visibility;
+
+private:
+
+	/**
+	 * \brief Apply impulse to every actor within the explosion radius, and start the occlusion traces for its damage.
+	 * \param Explosion The explosion to apply.
+	 */
+	void ApplyExplosion(const FNexusExplosion& Explosion);
+
+	/**
+	 * \brief Record whether anything blocks an explosion from reaching a component. Applies the explosion's damage once all of its traces have completed.
+	 */
+	void OnOcclusionTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/**
+	 * \brief Damage every actor with a component the explosion reached. Each actor is passed all of its exposed components.
+	 * \param PendingDamage The explosion, with its completed traces.
+	 */
+	void ApplyExplosionDamage(const FPendingExplosionDamage& PendingDamage);
+
+	/**
+	 * \brief Record an explosion being applied this frame.
+	 * \return true if the frame budget allows another explosion.
+	 */
+	bool HasFrameBudget();
+
+	/**
+	 * \brief Explosions waiting to be applied, oldest first.
+	 */
+	TArray<FNexusExplosion> QueuedExplosions;
+
+	/**
+	 * \brief Explosions waiting for their occlusion traces.
+	 */
+	TArray<FPendingExplosionDamage> PendingExplosionDamage;
+
+	/**
+	 * \brief Id of the next explosion to start its occlusion traces.
+	 */
+	uint32 NextExplosionId = 0;
+
+	/**
+	 * \brief Delegate called when an occlusion trace completes.
+	 */
+	FTraceDelegate OcclusionTraceDelegate;
+
+	/**
+	 * \brief Frame the explosion count was last reset.
+	 */
+	uint64 BudgetFrameNumber = 0;
+
+	/**
+	 * \brief Explosions applied this frame.
+	 */
+	int32 NumExplosionsThisFrame = 0;
+
+	/**
+	 * \brief Set while an explosion is being applied. Explosions triggered by its damage are queued, rather than recursing.
+	 */
+	bool bApplyingExplosion = false;
+};
@@ -0,0 +1,154 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusFootstepAudioSubsystem.generated.h"
+
+class ANexusCharacter;
+class UAudioComponent;
+class USkeletalMeshComponent;
+class USoundBase;
+
+/**
+ * \brief Surfaces that have their own footstep sound, and their own voice budget.
+ */
+enum class EFootstepSurface : uint8
+{
+	Grass,
+	Crouch,
+	Default,
+	Num
+};
+
+/**
+ * \brief Footstep sounds playing on one surface.
+ */
+struct FFootstepVoices
+{
+	/**
+	 * \brief Audio components of the footsteps played on the surface. Components are destroyed when their sound finishes.
+	 */
+	TArray<TWeakObjectPtr<UAudioComponent>> AudioComponents;
+
+	/**
+	 * \brief The maximum number of footsteps playing on the surface at once.
+	 */
+	int32 MaxVoices = 0;
+};
+
+/**
+ * \brief Plays character footstep sounds within a budget, so large crowds do not create an audio component for every footstep.
+ * Footsteps too far from every listener to be heard are culled, as are footsteps over the per frame or per surface budget.
+ * The local player's footsteps are exempt from the budgets, and are counted towards them. Not created on a dedicated server.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusFootstepAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Footsteps are purely cosmetic, so are not needed on a dedicated server.
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * \brief Play the footstep sound for the surface the character is standing on, unless it is culled.
+	 * \param Character The character taking the step.
+	 * \param MeshComponent The mesh the sound is attached to.
+	 */
+	void PlayFootstep(ANexusCharacter* Character, USkeletalMeshComponent* MeshComponent);
+
+protected:
+
+	/**
+	 * \brief Footsteps further than this from every listener are not played. Sounds with a shorter attenuation distance are culled at that distance instead.
+	 */
+	UPROPERTY(Config)
+	float MaxAudibleDistance = 3000.0f;
+
+	/**
+	 * \brief The maximum number of footsteps started in a single frame.
+	 */
+	UPROPERTY(Config)
+	int32 MaxFootstepsPerFrame = 4;
+
+	/**
+	 * \brief Voice budget for footsteps on grass.
+	 */
+	UPROPERTY(Config)
+	int32 MaxGrassVoices = 6;
+
+	/**
+	 * \brief Voice budget for crouched footsteps.
+	 */
+	UPROPERTY(Config)
+	int32 MaxCrouchVoices = 4;
+
+	/**
+	 * \brief Voice budget for footsteps on every other surface.
+	 */
+	UPROPERTY(Config)
+	int32 MaxDefaultVoices = 8;
+
+private:
+
+	/**
+	 * \brief Get the footstep surface of the floor the character is standing on.
+	 * \param Character The character taking the step.
+	 * \return The footstep surface.
+	 */
+	static EFootstepSurface GetFootstepSurface(const ANexusCharacter* Character);
+
+	/**
+	 * \brief Look up the sound the character plays for a footstep surface.
+	 * \param Character The character taking the step.
+	 * \param Surface The footstep surface.
+	 * \return The footstep sound, or nullptr if the character has none.
+	 */
+	static USoundBase* GetFootstepSound(const ANexusCharacter* Character, EFootstepSurface Surface);
+
+	/**
+	 * \brief Check if a location is close enough to a local listener for the sound to be heard.
+	 * \param Location The location of the footstep.
+	 * \param Sound The footstep sound.
+	 * \return true if the footstep can be heard.
+	 */
+	bool IsAudible(const FVector& Location, const USoundBase* Sound) const;
+
+	/**
+	 * \brief Remove the finished footsteps from a surface's voices.
+	 * \param Voices The surface's voices.
+	 * \return The number of footsteps still playing.
+	 */
+	static int32 UpdateVoices(FFootstepVoices& Voices);
+
+	/**
+	 * \brief Voices playing on each surface, indexed by EFootstepSurface.
+	 */
+	TArray<FFootstepVoices> SurfaceVoices;
+
+	/**
+	 * \brief The frame the per frame budget was last reset.
+	 */
+	uint64 BudgetFrameNumber = 0;
+
+	/**
+	 * \brief The number of footsteps started this frame.
+	 */
+	int32 FootstepsThisFrame = 0;
+
+	/**
+	 * \brief The number of footsteps played.
+	 */
+	uint32 NumFootstepsPlayed = 0;
+
+	/**
+	 * \brief The number of footsteps culled, because they could not be heard, or were over budget.
+	 */
+	uint32 NumFootstepsCulled = 0;
+};
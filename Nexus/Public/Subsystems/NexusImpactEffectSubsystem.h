@@ -0,0 +1,160 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusImpactEffectSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/**
+ * \brief Groups of surfaces that share an impact effect pool.
+ */
+enum class EImpactSurfaceGroup : uint8
+{
+	Head,
+	Body,
+	Limbs,
+	Default,
+	Num
+};
+
+/**
+ * \brief Particle components reused for the impact effects of one surface group.
+ */
+USTRUCT()
+struct FImpactEffectPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	/**
+	 * \brief Every component owned by the pool, active or idle.
+	 */
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Components;
+
+	/**
+	 * \brief The order each component was last activated in. Used to find the oldest active effect.
+	 */
+	TArray<uint32> ActivationOrder;
+
+	/**
+	 * \brief The maximum number of components the pool can own.
+	 */
+	int32 MaxPoolSize = 0;
+
+	/**
+	 * \brief The number of effects played with an idle pooled component.
+	 */
+	uint32 PoolHits = 0;
+
+	/**
+	 * \brief The number of effects that had to create a component, or recycle an active one.
+	 */
+	uint32 PoolMisses = 0;
+};
+
+/**
+ * \brief Plays weapon impact effects from pre-warmed pools of particle components, instead of spawning a component per impact.
+ * Each surface group has its own pool budget, and the number of active effects is capped. When a budget is used up the oldest effect is recycled.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusImpactEffectSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Impact effects are purely cosmetic, so are not needed on a dedicated server.
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * \brief Create the pooled components up front, so the first impacts do not pay for creating them. Only warms the pools once.
+	 */
+	void WarmPools();
+
+	/**
+	 * \brief Play an impact effect using a pooled particle component.
+	 * \param ImpactVFX Particle effect to play.
+	 * \param SurfaceType The type of surface that was hit. Selects the pool.
+	 * \param Location The location of the impact.
+	 * \param Rotation The rotation of the effect.
+	 */
+	void PlayImpactEffect(UParticleSystem* ImpactVFX, EPhysicalSurface SurfaceType, const FVector& Location, const FRotator& Rotation);
+
+protected:
+
+	/**
+	 * \brief Pool budget for character head impacts.
+	 */
+	UPROPERTY(Config)
+	int32 HeadPoolSize = 8;
+
+	/**
+	 * \brief Pool budget for character body impacts.
+	 */
+	UPROPERTY(Config)
+	int32 BodyPoolSize = 16;
+
+	/**
+	 * \brief Pool budget for character limb impacts.
+	 */
+	UPROPERTY(Config)
+	int32 LimbsPoolSize = 8;
+
+	/**
+	 * \brief Pool budget for impacts on every other surface.
+	 */
+	UPROPERTY(Config)
+	int32 DefaultPoolSize = 32;
+
+	/**
+	 * \brief The number of components created per pool when the pools are warmed.
+	 */
+	UPROPERTY(Config)
+	int32 WarmPoolSize = 4;
+
+	/**
+	 * \brief The maximum number of impact effects active at once, across all pools.
+	 */
+	UPROPERTY(Config)
+	int32 MaxActiveImpactEffects = 48;
+
+private:
+
+	/**
+	 * \brief Get the pool used for a surface type.
+	 * \param SurfaceType The type of surface that was hit.
+	 * \return Surface group of the pool.
+	 */
+	static EImpactSurfaceGroup GetSurfaceGroup(EPhysicalSurface SurfaceType);
+
+	/**
+	 * \brief Create a registered, inactive particle component and add it to a pool.
+	 * \param Pool The pool that owns the component.
+	 * \return Index of the component in the pool.
+	 */
+	int32 AddPooledComponent(FImpactEffectPool& Pool);
+
+	/**
+	 * \brief Count the impact effects currently playing in every pool.
+	 * \return Number of active effects.
+	 */
+	int32 CountActiveImpactEffects() const;
+
+	/**
+	 * \brief One pool per surface group, indexed by EImpactSurfaceGroup.
+	 */
+	UPROPERTY()
+	TArray<FImpactEffectPool> Pools;
+
+	/**
+	 * \brief Incremented every time an effect is activated.
+	 */
+	uint32 NextActivationOrder = 0;
+};
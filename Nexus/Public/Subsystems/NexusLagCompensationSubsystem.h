@@ -0,0 +1,91 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusLagCompensationSubsystem.generated.h"
+
+class UNexusHitboxHistoryComponent;
+
+/**
+ * \brief Tracks every hitbox history in the world, and rewinds them so the server can trace shots against the world the client saw when it fired.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusLagCompensationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * \brief Add a hitbox history to be rewound.
+	 * \param HitboxHistory
+	 */
+	void RegisterHitboxHistory(UNexusHitboxHistoryComponent* HitboxHistory);
+
+	/**
+	 * \brief Remove a hitbox history.
+	 * \param HitboxHistory
+	 */
+	void UnregisterHitboxHistory(UNexusHitboxHistoryComponent* HitboxHistory);
+
+	/**
+	 * \brief Rewind every registered hitbox history to the given time. Must be followed by RestoreHitboxes.
+	 * \param RewindTime The server world time the client fired at. Clamped to MaxRewindTime.
+	 * \param IgnoredActor Actor that should not be rewound. (The shooter)
+	 */
+	void RewindHitboxes(float RewindTime, const AActor* IgnoredActor);
+
+	/**
+	 * \brief Restore every hitbox history that was moved by RewindHitboxes.
+	 */
+	void RestoreHitboxes();
+
+protected:
+
+	/**
+	 * \brief The furthest back in time (in seconds) the server will rewind for a client shot.
+	 */
+	UPROPERTY(Config)
+	float MaxRewindTime = 0.3f;
+
+private:
+
+	/**
+	 * \brief Every hitbox history in the world.
+	 */
+	UPROPERTY()
+	TArray<UNexusHitboxHistoryComponent*> HitboxHistories;
+
+	/**
+	 * \brief Hitbox histories moved by the current rewind. Storage is reserved as histories are registered.
+	 */
+	TArray<UNexusHitboxHistoryComponent*> RewoundHitboxHistories;
+};
+
+/**
+ * \brief Rewinds hitbox histories for the lifetime of the scope.
+ */
+struct NEXUS_API FNexusScopedLagCompensation
+{
+	/**
+	 * \brief Rewind hitbox histories.
+	 * \param World The world the shot was fired in.
+	 * \param RewindTime The server world time the client fired at.
+	 * \param IgnoredActor Actor that should not be rewound. (The shooter)
+	 */
+	FNexusScopedLagCompensation(UWorld* World, float RewindTime, const AActor* IgnoredActor);
+
+	/**
+	 * \brief Restore hitbox histories.
+	 */
+	~FNexusScopedLagCompensation();
+
+private:
+
+	/**
+	 * \brief The subsystem that performed the rewind.
+	 */
+	UNexusLagCompensationSubsystem* LagCompensationSubsystem;
+};
@@ -0,0 +1,62 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusMeshMergeSubsystem.generated.h"
+
+class USkeletalMesh;
+
+/**
+ * \brief Merges character appearance parts into a single skeletal mesh, so each character draws and updates one mesh rather than several attachments.
+ * Merged meshes are cached by the parts they were built from, so repeated combinations share the same mesh. Not created on a dedicated server.
+ */
+UCLASS()
+class NEXUS_API UNexusMeshMergeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * \brief Get the mesh made by merging the parts, merging them if the combination has not been used before.
+	 * \param Parts Meshes skinned to the same skeleton. The first part is the base mesh, whose physics asset is used.
+	 * \return The merged mesh, or nullptr if the parts could not be merged.
+	 */
+	USkeletalMesh* GetMergedMesh(const TArray<USkeletalMesh*>& Parts);
+
+	/**
+	 * \brief Get the material indices of a part's sections in a mesh merged from the parts. Each part's sections are kept as their own sections, in part order.
+	 * \param MergedMesh The mesh merged from the parts.
+	 * \param Parts The parts the mesh was merged from.
+	 * \param PartIndex The index of the part.
+	 * \param MaterialIndicesOut The merged mesh's material index of each of the part's sections.
+	 */
+	static void GetPartMaterialIndices(USkeletalMesh* MergedMesh, const TArray<USkeletalMesh*>& Parts, int32 PartIndex, TArray<int32>& MaterialIndicesOut);
+
+private:
+
+	/**
+	 * \brief Get the number of sections in a mesh's first LOD, which is the LOD merged.
+	 * \param Mesh The mesh.
+	 * \return The number of sections.
+	 */
+	static int32 GetNumSections(USkeletalMesh* Mesh);
+
+	/**
+	 * \brief Build the cache key of a combination of parts.
+	 * \param Parts The parts to merge, in order.
+	 * \return The key of the combination.
+	 */
+	static FString GetVariantKey(const TArray<USkeletalMesh*>& Parts);
+
+	/**
+	 * \brief Merged meshes, keyed by the parts they were built from.
+	 */
+	UPROPERTY(Transient)
+	TMap<FString, USkeletalMesh*> MergedMeshes;
+};
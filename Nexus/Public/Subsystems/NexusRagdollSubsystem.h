@@ -0,0 +1,129 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+#include "NexusRagdollSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * \brief A skeletal mesh simulating as a ragdoll.
+ */
+struct FNexusRagdoll
+{
+	/**
+	 * \brief The simulating mesh.
+	 */
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/**
+	 * \brief The number of physics bodies simulated by the mesh.
+	 */
+	int32 NumBodies = 0;
+
+	/**
+	 * \brief World time the ragdoll started simulating.
+	 */
+	float StartTime = 0.0f;
+
+	/**
+	 * \brief World time the ragdoll slowed below the settle speed. (< 0 = still moving)
+	 */
+	float SettleStartTime = -1.0f;
+};
+
+/**
+ * \brief Keeps the number of simulating ragdoll bodies within a budget, so the physics step stays bounded however many characters die at once.
+ * When the budget is exceeded, the oldest ragdolls are frozen in their current pose. Ragdolls are also frozen once they settle.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusRagdollSubsystem : public UNexusTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * \brief Start tracking a mesh that has started simulating physics. The oldest ragdolls are frozen if the budget is exceeded.
+	 * \param Mesh The simulating mesh.
+	 */
+	void RegisterRagdoll(USkeletalMeshComponent* Mesh);
+
+	/**
+	 * \brief Stop tracking a mesh without freezing it, e.g. when the ragdoll is reset for reuse.
+	 * \param Mesh The mesh to stop tracking.
+	 */
+	void UnregisterRagdoll(USkeletalMeshComponent* Mesh);
+
+	/**
+	 * \brief Get the number of bodies currently simulating.
+	 * \return The number of simulating bodies.
+	 */
+	int32 GetNumSimulatingBodies() const;
+
+protected:
+
+	/**
+	 * \brief The maximum number of ragdoll bodies simulating at once.
+	 */
+	UPROPERTY(Config)
+	int32 MaxSimulatingBodies = 256;
+
+	/**
+	 * \brief Ragdolls moving slower than this are settling. (cm/s)
+	 */
+	UPROPERTY(Config)
+	float SettleSpeed = 5.0f;
+
+	/**
+	 * \brief Seconds a ragdoll must stay slower than the settle speed before it is frozen.
+	 */
+	UPROPERTY(Config)
+	float SettleTime = 0.5f;
+
+	/**
+	 * \brief Ragdolls are frozen after simulating for this long, even if they have not settled.
+	 */
+	UPROPERTY(Config)
+	float MaxSimulationTime = 8.0f;
+
+private:
+
+	/**
+	 * \brief Check if a ragdoll has settled, or has simulated for too long.
+	 * \param Ragdoll The ragdoll to check. Its settle time is updated.
+	 * \param WorldTime The current world time.
+	 * \return true if the ragdoll should be frozen.
+	 */
+	bool ShouldFreezeRagdoll(FNexusRagdoll& Ragdoll, float WorldTime) const;
+
+	/**
+	 * \brief Freeze the oldest ragdolls until the simulating bodies are within the budget.
+	 */
+	void EnforceBudget();
+
+	/**
+	 * \brief Stop a ragdoll simulating and keep its current pose.
+	 * \param RagdollIndex The index of the ragdoll to freeze. It is removed.
+	 */
+	void FreezeRagdollAt(int32 RagdollIndex);
+
+	/**
+	 * \brief Simulating ragdolls, oldest first.
+	 */
+	TArray<FNexusRagdoll> Ragdolls;
+
+	/**
+	 * \brief The number of bodies simulated by every tracked ragdoll.
+	 */
+	int32 NumSimulatingBodies = 0;
+};
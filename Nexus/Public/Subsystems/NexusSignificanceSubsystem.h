@@ -0,0 +1,158 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+#include "Interfaces/NexusSignificanceInterface.h"
+#include "NexusSignificanceSubsystem.generated.h"
+
+/**
+ * \brief An actor managed by the significance subsystem.
+ */
+struct FNexusSignificanceEntry
+{
+	/**
+	 * \brief The managed actor.
+	 */
+	TWeakObjectPtr<AActor> Actor;
+
+	/**
+	 * \brief The actor's current significance tier.
+	 */
+	ENexusSignificanceTier Tier = ENexusSignificanceTier::High;
+
+	/**
+	 * \brief The actor's tick interval when it was registered. Used by the High tier.
+	 */
+	float DefaultTickInterval = 0.0f;
+};
+
+/**
+ * \brief Scores registered actors by distance to the nearest player and whether they were recently rendered, and sorts them into tiers.
+ * Each tier sets the actor's tick interval, so far away actors tick at a few Hz. Player controlled pawns are always High.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusSignificanceSubsystem : public UNexusTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * \brief Start managing an actor's significance. The actor starts in the High tier.
+	 * \param Actor The actor to manage.
+	 */
+	void RegisterActor(AActor* Actor);
+
+	/**
+	 * \brief Stop managing an actor's significance, and restore its full tick rate.
+	 * \param Actor The actor to stop managing.
+	 */
+	void UnregisterActor(AActor* Actor);
+
+	/**
+	 * \brief Get the number of managed actors in a tier.
+	 * \param Tier The significance tier.
+	 * \return The number of actors in the tier, as of the last update.
+	 */
+	int32 GetNumActorsInTier(ENexusSignificanceTier Tier) const;
+
+protected:
+
+	/**
+	 * \brief Seconds between significance updates.
+	 */
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	/**
+	 * \brief Actors closer than this to a player are High significance.
+	 */
+	UPROPERTY(Config)
+	float HighSignificanceDistance = 2000.0f;
+
+	/**
+	 * \brief Actors closer than this to a player are Medium significance.
+	 */
+	UPROPERTY(Config)
+	float MediumSignificanceDistance = 5000.0f;
+
+	/**
+	 * \brief Actors closer than this to a player are Low significance. Anything further away is Culled.
+	 */
+	UPROPERTY(Config)
+	float LowSignificanceDistance = 10000.0f;
+
+	/**
+	 * \brief Actors that have not been rendered within this many seconds drop one tier. Not used on a dedicated server.
+	 */
+	UPROPERTY(Config)
+	float RecentlyRenderedTime = 0.5f;
+
+	/**
+	 * \brief Tick interval of Medium significance actors. (0 = every frame)
+	 */
+	UPROPERTY(Config)
+	float MediumTickInterval = 0.05f;
+
+	/**
+	 * \brief Tick interval of Low significance actors.
+	 */
+	UPROPERTY(Config)
+	float LowTickInterval = 0.2f;
+
+	/**
+	 * \brief Tick interval of Culled actors.
+	 */
+	UPROPERTY(Config)
+	float CulledTickInterval = 0.5f;
+
+private:
+
+	/**
+	 * \brief Score every managed actor, and move those whose tier has changed.
+	 */
+	void UpdateSignificance();
+
+	/**
+	 * \brief Work out an actor's tier from the view locations of every player.
+	 * \return The actor's significance tier.
+	 */
+	ENexusSignificanceTier CalculateTier(const AActor* Actor, const TArray<FVector, TInlineAllocator<4>>& ViewLocations) const;
+
+	/**
+	 * \brief Apply a tier's tick interval to an actor, and notify it of the change.
+	 * \param Entry The actor's entry. Its tier is updated.
+	 * \param Tier The actor's new tier.
+	 */
+	void ApplyTier(FNexusSignificanceEntry& Entry, ENexusSignificanceTier Tier) const;
+
+	/**
+	 * \brief Get the tick interval used by a tier.
+	 * \return Tick interval in seconds.
+	 */
+	float GetTierTickInterval(const FNexusSignificanceEntry& Entry, ENexusSignificanceTier Tier) const;
+
+	/**
+	 * \brief Managed actors.
+	 */
+	TArray<FNexusSignificanceEntry> Entries;
+
+	/**
+	 * \brief The number of managed actors in each tier, as of the last update.
+	 */
+	int32 NumActorsPerTier[static_cast<int32>(ENexusSignificanceTier::Num)] = {};
+
+	/**
+	 * \brief Seconds until the next significance update.
+	 */
+	float TimeUntilUpdate = 0.0f;
+};
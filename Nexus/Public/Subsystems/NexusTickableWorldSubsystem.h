@@ -0,0 +1,24 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NexusTickableWorldSubsystem.generated.h"
+
+/**
+ * \brief Base class for world subsystems that tick with their world. Only the subsystem instances tick, never the class default object.
+ * Subclasses implement Tick and GetStatId, and can override IsTickable to skip frames with nothing to do.
+ */
+UCLASS(Abstract)
+class NEXUS_API UNexusTickableWorldSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// FTickableGameObject
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+};
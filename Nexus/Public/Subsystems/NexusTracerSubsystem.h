@@ -0,0 +1,177 @@
+// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/NexusTickableWorldSubsystem.h"
+#include "NexusTracerSubsystem.generated.h"
+
+class UStaticMesh;
+class UMaterialInterface;
+class UInstancedStaticMeshComponent;
+
+/**
+ * \brief A single bullet tracer travelling from the muzzle to the shot target.
+ */
+struct FTracerSegment
+{
+	/**
+	 * \brief Where the tracer starts.
+	 */
+	FVector Start;
+
+	/**
+	 * \brief Direction of travel.
+	 */
+	FVector Direction;
+
+	/**
+	 * \brief Distance between the start and the shot target.
+	 */
+	float Length;
+
+	/**
+	 * \brief World time the tracer was fired.
+	 */
+	float StartTime;
+
+	/**
+	 * \brief Is the tracer still travelling.
+	 */
+	bool bActive;
+};
+
+/**
+ * \brief Every tracer drawn with one mesh and material. All of them are instances of a single component.
+ */
+USTRUCT()
+struct FTracerBatch
+{
+	GENERATED_USTRUCT_BODY()
+
+	/**
+	 * \brief Mesh drawn for each tracer. Expected to point along X, with the pivot at its centre.
+	 */
+	UPROPERTY()
+	UStaticMesh* TracerMesh = nullptr;
+
+	/**
+	 * \brief Material drawn on each tracer.
+	 */
+	UPROPERTY()
+	UMaterialInterface* TracerMaterial = nullptr;
+
+	/**
+	 * \brief Component that draws the tracers. Has one instance per segment.
+	 */
+	UPROPERTY()
+	UInstancedStaticMeshComponent* InstancedMeshComponent = nullptr;
+
+	/**
+	 * \brief Ring buffer of tracers. The oldest tracer is overwritten when it is full.
+	 */
+	TArray<FTracerSegment> Segments;
+
+	/**
+	 * \brief Instance transforms, reused every frame.
+	 */
+	TArray<FTransform> InstanceTransforms;
+
+	/**
+	 * \brief Index of the segment the next tracer is written to.
+	 */
+	int32 NextSegmentIndex = 0;
+
+	/**
+	 * \brief Number of tracers still travelling.
+	 */
+	int32 NumActiveSegments = 0;
+
+	/**
+	 * \brief Length of the tracer mesh along X. Used to scale instances to the tracer length.
+	 */
+	float MeshLength = 1.0f;
+};
+
+/**
+ * \brief Draws every bullet tracer in the world from a ring buffer of segments, with one instanced mesh component per tracer mesh.
+ * Replaces spawning a particle component per shot.
+ */
+UCLASS(Config = Game)
+class NEXUS_API UNexusTracerSubsystem : public UNexusTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Tracers are purely cosmetic, so are not needed on a dedicated server.
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * \brief Fire a tracer.
+	 * \param TracerMesh Mesh drawn for the tracer.
+	 * \param TracerMaterial Material drawn on the tracer. Uses the mesh material if null.
+	 * \param Start Where the tracer starts. (The weapon muzzle)
+	 * \param Target Where the tracer ends. (The shot target)
+	 */
+	void AddTracer(UStaticMesh* TracerMesh, UMaterialInterface* TracerMaterial, const FVector& Start, const FVector& Target);
+
+protected:
+
+	/**
+	 * \brief The maximum number of tracers drawn at once for each tracer mesh.
+	 */
+	UPROPERTY(Config)
+	int32 MaxTracersPerBatch = 128;
+
+	/**
+	 * \brief How fast tracers travel. (cm/s)
+	 */
+	UPROPERTY(Config)
+	float TracerSpeed = 30000.0f;
+
+	/**
+	 * \brief Length of the visible tracer streak. (cm)
+	 */
+	UPROPERTY(Config)
+	float TracerLength = 400.0f;
+
+private:
+
+	/**
+	 * \brief Find the batch for a mesh and material, creating it if needed.
+	 * \return The batch, or null if its component could not be created.
+	 */
+	FTracerBatch* FindOrAddBatch(UStaticMesh* TracerMesh, UMaterialInterface* TracerMaterial);
+
+	/**
+	 * \brief Move every active tracer in a batch, and hide the ones that have arrived.
+	 * \param Batch The batch to update.
+	 * \param CurrentTime The current world time.
+	 */
+	void UpdateBatch(FTracerBatch& Batch, float CurrentTime) const;
+
+	/**
+	 * \brief Actor that owns the instanced mesh components.
+	 */
+	UPROPERTY()
+	AActor* TracerActor = nullptr;
+
+	/**
+	 * \brief One batch per tracer mesh and material.
+	 */
+	UPROPERTY()
+	TArray<FTracerBatch> Batches;
+
+	/**
+	 * \brief Number of tracers still travelling, across all batches.
+	 */
+	int32 NumActiveTracers = 0;
+};
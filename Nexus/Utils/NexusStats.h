@@ -0,0 +1,10 @@
+﻿// Toyan Green © 2020
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Stat group used to profile gameplay systems. Displayed with "stat Nexus".
+
+DECLARE_STATS_GROUP(TEXT("Nexus"), STATGROUP_Nexus, STATCAT_Advanced);